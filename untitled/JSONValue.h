@@ -0,0 +1,4053 @@
+//
+// Created by Elina Naghashyan on 03.01.25.
+// JSON Parser in C++
+//
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <variant>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <charconv>
+#include <cctype>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cassert>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Arena for the parse tree: every object/array node parsed through it is
+// carved out of large monotonic slabs, so freeing the arena releases the
+// whole document at once instead of paying one free() per node. Values
+// parsed into an arena must not outlive it.
+class JSONArena {
+public:
+    explicit JSONArena(size_t slabSize = 1 << 20) : pool(slabSize) {}
+
+    std::pmr::memory_resource* resource() { return &pool; }
+
+    // Drop every slab in one go (O(slab count), not O(node count))
+    void release() { pool.release(); }
+
+private:
+    std::pmr::monotonic_buffer_resource pool;
+};
+
+
+class JSONValue;
+
+// Insertion-ordered flat object: members sit contiguously in a vector,
+// so iteration is cache-friendly and serialization order is stable
+// (unordered_map made diffs of serializeJSON output useless). Typical
+// objects have a handful of keys, so lookups scan linearly; once an
+// object grows past kIndexThreshold members a hash index is built
+// lazily and rebuilt after mutations.
+class JSONObject {
+public:
+    using Member = std::pair<std::string, JSONValue>;
+    using iterator = std::pmr::vector<Member>::iterator;
+    using const_iterator = std::pmr::vector<Member>::const_iterator;
+
+    JSONObject() = default;
+    explicit JSONObject(std::pmr::memory_resource* res) : members(res) {}
+
+    // The hash index holds views into our own keys, so it never travels
+    // with a copy or move; it is rebuilt on demand
+    JSONObject(const JSONObject& other);
+    JSONObject(JSONObject&& other) noexcept;
+    JSONObject& operator=(const JSONObject& other);
+    JSONObject& operator=(JSONObject&& other) noexcept;
+    ~JSONObject();
+
+    size_t size() const { return members.size(); }
+    bool empty() const { return members.empty(); }
+
+    iterator begin() { return members.begin(); }
+    iterator end() { return members.end(); }
+    const_iterator begin() const { return members.begin(); }
+    const_iterator end() const { return members.end(); }
+
+    size_t count(std::string_view key) const { return findIndex(key) == npos ? 0 : 1; }
+
+    iterator find(std::string_view key);
+    const_iterator find(std::string_view key) const;
+
+    JSONValue& at(std::string_view key);
+    const JSONValue& at(std::string_view key) const;
+    JSONValue& operator[](const std::string& key);
+    JSONValue& operator[](std::string&& key);
+
+    size_t erase(std::string_view key);
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr size_t kIndexThreshold = 32;
+
+    std::pmr::vector<Member> members;
+    mutable std::unordered_map<std::string_view, size_t> index;
+
+    size_t findIndex(std::string_view key) const;
+};
+
+// Represent a JSON value
+class JSONValue {
+public:
+    enum class Type { OBJECT, ARRAY, STRING, NUMBER, BOOLEAN, NULLVALUE };
+
+    using Object = JSONObject;
+    using Array = std::pmr::vector<JSONValue>;
+
+    // Scalar token spans recorded by the lazy parse mode; decoded and
+    // cached in place on first access
+    struct RawString { std::string_view raw; };
+    struct RawNumber { std::string_view text; };
+
+    // Default constructor
+    JSONValue() : data(std::monostate{}) {}
+
+    // Constructor for strings (const char* overload keeps literals from binding to bool)
+    explicit JSONValue(std::string val) : data(std::move(val)) {}
+    explicit JSONValue(const char* val) : data(std::string(val)) {}
+
+    // Constructor for borrowed strings: a view into a buffer someone else
+    // keeps alive (the parser's input in zero-copy mode)
+    explicit JSONValue(std::string_view val) : data(val) {}
+
+    // Constructors for undecoded scalar spans (lazy parse mode)
+    explicit JSONValue(RawString val) : data(val) {}
+    explicit JSONValue(RawNumber val) : data(val) {}
+
+    // Constructor for numbers
+    explicit JSONValue(double val) : data(val) {}
+
+    // Constructor for booleans
+    explicit JSONValue(bool val) : data(val) {}
+
+    // Constructor for object and array types; containers draw from the
+    // given memory resource (the default is plain new/delete)
+    explicit JSONValue(Type val, std::pmr::memory_resource* res = std::pmr::get_default_resource()) {
+        switch (val) {
+            case Type::OBJECT: data = Object{res}; break;
+            case Type::ARRAY: data = Array{res}; break;
+            case Type::STRING: data = std::string{}; break;
+            case Type::NUMBER: data = 0.0; break;
+            case Type::BOOLEAN: data = false; break;
+            case Type::NULLVALUE: data = std::monostate{}; break;
+        }
+    }
+
+    JSONValue(const JSONValue&) = default;
+    JSONValue(JSONValue&&) = default;
+    JSONValue& operator=(const JSONValue&) = default;
+    JSONValue& operator=(JSONValue&&) = default;
+
+    // Teardown is flattened with a worklist; see the definition below
+    ~JSONValue();
+
+    Type type() const {
+        switch (data.index()) {
+            case 1: return Type::BOOLEAN;
+            case 2: return Type::NUMBER;
+            case 3: return Type::STRING;
+            case 4: return Type::OBJECT;
+            case 5: return Type::ARRAY;
+            case 6: return Type::STRING; // borrowed string_view
+            case 7: return Type::STRING; // undecoded RawString
+            case 8: return Type::NUMBER; // undecoded RawNumber
+            case 9: return Type::OBJECT; // shared subtree
+            case 10: return Type::ARRAY; // shared subtree
+            default: return Type::NULLVALUE;
+        }
+    }
+
+    // Accessors; std::get throws if the value holds a different type.
+    // Borrowed views and undecoded lazy spans are materialized into the
+    // owned representation on first access (defined after the lexing
+    // helpers they reuse); the value is logically const but not safe to
+    // decode from two threads at once.
+    std::string& stringValue();
+    const std::string& stringValue() const;
+
+    // Read-only string contents, owned or borrowed alike
+    std::string_view stringView() const;
+
+    double& numberValue();
+    double numberValue() const;
+
+    bool& boolValue() { return std::get<bool>(data); }
+    bool boolValue() const { return std::get<bool>(data); }
+
+    // Container access performs copy-on-write for shared subtrees: the
+    // const overloads read through the shared node, while the mutable
+    // overloads clone it first if anyone else still holds a reference.
+    // The clone is shallow — shared children stay shared — so mutating
+    // one leaf of a widely shared document clones only the spine above
+    // it, not the whole tree.
+    Object& objectValue() {
+        if (auto* shared = std::get_if<std::shared_ptr<Object>>(&data)) {
+            if (shared->use_count() > 1) {
+                *shared = std::make_shared<Object>(**shared);
+            }
+            return **shared;
+        }
+        return std::get<Object>(data);
+    }
+    const Object& objectValue() const {
+        if (auto* shared = std::get_if<std::shared_ptr<Object>>(&data)) {
+            return **shared;
+        }
+        return std::get<Object>(data);
+    }
+
+    Array& arrayValue() {
+        if (auto* shared = std::get_if<std::shared_ptr<Array>>(&data)) {
+            if (shared->use_count() > 1) {
+                *shared = std::make_shared<Array>(**shared);
+            }
+            return **shared;
+        }
+        return std::get<Array>(data);
+    }
+    const Array& arrayValue() const {
+        if (auto* shared = std::get_if<std::shared_ptr<Array>>(&data)) {
+            return **shared;
+        }
+        return std::get<Array>(data);
+    }
+
+    // Move every container in this tree behind a refcounted pointer.
+    // Copies of any subtree then cost a refcount bump instead of a deep
+    // copy, so near-identical document variants share their unchanged
+    // branches; mutation clones the touched path back out (see above).
+    void shareSubtrees() {
+        std::vector<JSONValue*> pending{this};
+        while (!pending.empty()) {
+            JSONValue* node = pending.back();
+            pending.pop_back();
+            if (auto* object = std::get_if<Object>(&node->data)) {
+                auto shared = std::make_shared<Object>(std::move(*object));
+                for (auto& member : *shared) {
+                    pending.push_back(&member.second);
+                }
+                node->data = std::move(shared);
+            } else if (auto* array = std::get_if<Array>(&node->data)) {
+                auto shared = std::make_shared<Array>(std::move(*array));
+                for (auto& child : *shared) {
+                    pending.push_back(&child);
+                }
+                node->data = std::move(shared);
+            }
+            // already-shared nodes were converted when first shared
+        }
+    }
+
+    // Identity of the shared node backing this value, or nullptr for
+    // plain storage; two values with the same identity are equal without
+    // walking them
+    const void* sharedIdentity() const {
+        if (auto* shared = std::get_if<std::shared_ptr<Object>>(&data)) {
+            return shared->get();
+        }
+        if (auto* shared = std::get_if<std::shared_ptr<Array>>(&data)) {
+            return shared->get();
+        }
+        return nullptr;
+    }
+
+private:
+    // One alternative per Type, so each node only pays for what it holds;
+    // STRING has owned, borrowed and undecoded representations, and
+    // containers a plain and a shared (copy-on-write) one. Mutable so
+    // that first access through a const ref can cache the decoded form.
+    mutable std::variant<std::monostate, bool, double, std::string, Object, Array,
+                         std::string_view, RawString, RawNumber,
+                         std::shared_ptr<Object>, std::shared_ptr<Array>> data;
+
+    void materialize() const;
+};
+
+// The variant would tear down nested containers recursively, so a
+// document deep enough to need the iterative parse and serialize engines
+// could still overflow the call stack when it is destroyed. Instead,
+// nested containers are lifted out onto an explicit worklist (leaving
+// monostate behind) and destroyed one level at a time.
+inline JSONValue::~JSONValue() {
+    if (data.index() < 4 || data.index() == 6 || data.index() == 7 || data.index() == 8) return;
+    std::vector<JSONValue> pending;
+    auto drain = [&pending](JSONValue& node) {
+        auto lift = [&pending](JSONValue& child) {
+            switch (child.data.index()) {
+                case 4: case 5: case 9: case 10:
+                    pending.push_back(std::move(child));
+                    child.data = std::monostate{};
+                default:
+                    break;
+            }
+        };
+        // A shared node about to lose its last reference is drained like
+        // a plain one; one still referenced elsewhere just drops a count
+        Object* object = std::get_if<Object>(&node.data);
+        Array* array = std::get_if<Array>(&node.data);
+        if (auto* shared = std::get_if<std::shared_ptr<Object>>(&node.data)) {
+            if (shared->use_count() != 1) return;
+            object = shared->get();
+        } else if (auto* shared = std::get_if<std::shared_ptr<Array>>(&node.data)) {
+            if (shared->use_count() != 1) return;
+            array = shared->get();
+        }
+        if (array) {
+            for (auto& child : *array) lift(child);
+        } else if (object) {
+            for (auto& member : *object) lift(member.second);
+        }
+    };
+    drain(*this);
+    while (!pending.empty()) {
+        JSONValue node = std::move(pending.back());
+        pending.pop_back();
+        drain(node);
+    }
+}
+
+inline JSONObject::JSONObject(const JSONObject& other) : members(other.members) {}
+inline JSONObject::JSONObject(JSONObject&& other) noexcept : members(std::move(other.members)) {}
+inline JSONObject::~JSONObject() = default;
+
+inline JSONObject& JSONObject::operator=(const JSONObject& other) {
+    members = other.members;
+    index.clear();
+    return *this;
+}
+
+inline JSONObject& JSONObject::operator=(JSONObject&& other) noexcept {
+    members = std::move(other.members);
+    index.clear();
+    return *this;
+}
+
+inline size_t JSONObject::findIndex(std::string_view key) const {
+    if (members.size() >= kIndexThreshold) {
+        if (index.size() != members.size()) {
+            index.clear();
+            for (size_t i = 0; i < members.size(); ++i) {
+                index.emplace(members[i].first, i);
+            }
+        }
+        auto it = index.find(key);
+        return it == index.end() ? npos : it->second;
+    }
+    for (size_t i = 0; i < members.size(); ++i) {
+        if (members[i].first == key) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+inline JSONObject::iterator JSONObject::find(std::string_view key) {
+    size_t idx = findIndex(key);
+    return idx == npos ? members.end() : members.begin() + idx;
+}
+
+inline JSONObject::const_iterator JSONObject::find(std::string_view key) const {
+    size_t idx = findIndex(key);
+    return idx == npos ? members.end() : members.begin() + idx;
+}
+
+inline JSONValue& JSONObject::at(std::string_view key) {
+    size_t idx = findIndex(key);
+    if (idx == npos) {
+        throw std::out_of_range("Key not found: " + std::string(key));
+    }
+    return members[idx].second;
+}
+
+inline const JSONValue& JSONObject::at(std::string_view key) const {
+    size_t idx = findIndex(key);
+    if (idx == npos) {
+        throw std::out_of_range("Key not found: " + std::string(key));
+    }
+    return members[idx].second;
+}
+
+inline JSONValue& JSONObject::operator[](const std::string& key) {
+    size_t idx = findIndex(key);
+    if (idx == npos) {
+        members.emplace_back(key, JSONValue());
+        index.clear();
+        return members.back().second;
+    }
+    return members[idx].second;
+}
+
+inline JSONValue& JSONObject::operator[](std::string&& key) {
+    size_t idx = findIndex(key);
+    if (idx == npos) {
+        members.emplace_back(std::move(key), JSONValue());
+        index.clear();
+        return members.back().second;
+    }
+    return members[idx].second;
+}
+
+inline size_t JSONObject::erase(std::string_view key) {
+    size_t idx = findIndex(key);
+    if (idx == npos) {
+        return 0;
+    }
+    members.erase(members.begin() + idx);
+    index.clear();
+    return 1;
+}
+
+// ---- Vectorized scanning kernels ----
+// The parser's two hottest loops walk the input one byte at a time:
+// skipping whitespace on pretty-printed documents and scanning string
+// bodies for the closing quote or an escape. These kernels do the same
+// work 16-32 bytes per step, with a scalar tail/fallback so every
+// platform keeps working. JSON whitespace plus \v and \f matches what
+// std::isspace accepted before.
+
+inline size_t scanWhitespaceScalar(const char* data, size_t size, size_t pos) {
+    while (pos < size && std::isspace(static_cast<unsigned char>(data[pos]))) {
+        pos++;
+    }
+    return pos;
+}
+
+inline size_t scanStringScalar(const char* data, size_t size, size_t pos) {
+    while (pos < size && data[pos] != '"' && data[pos] != '\\') {
+        pos++;
+    }
+    return pos;
+}
+
+// Serializer-side classifier: first byte that cannot be emitted verbatim
+// inside a JSON string (quote, backslash, or a control character)
+inline size_t scanEscapeScalar(const char* data, size_t size, size_t pos) {
+    while (pos < size && data[pos] != '"' && data[pos] != '\\' &&
+           static_cast<unsigned char>(data[pos]) >= 0x20) {
+        pos++;
+    }
+    return pos;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+inline size_t scanWhitespaceSSE2(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        // Whitespace is ' ' or anything in [\t, \r] (9..13)
+        __m128i isSpace = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(' '));
+        __m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8('\t'));
+        __m128i isCtrl = _mm_cmpeq_epi8(_mm_subs_epu8(shifted, _mm_set1_epi8(4)), _mm_setzero_si128());
+        int wsMask = _mm_movemask_epi8(_mm_or_si128(isSpace, isCtrl));
+        int nonWs = ~wsMask & 0xFFFF;
+        if (nonWs != 0) {
+            return pos + __builtin_ctz(nonWs);
+        }
+        pos += 16;
+    }
+    return scanWhitespaceScalar(data, size, pos);
+}
+
+inline size_t scanStringSSE2(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 16;
+    }
+    return scanStringScalar(data, size, pos);
+}
+
+inline size_t scanEscapeSSE2(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+                                       _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        // Controls: unsigned chunk <= 0x1F, i.e. max(chunk, 0x1F) == 0x1F
+        __m128i isCtrl = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x1F)),
+                                        _mm_set1_epi8(0x1F));
+        int mask = _mm_movemask_epi8(_mm_or_si128(special, isCtrl));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 16;
+    }
+    return scanEscapeScalar(data, size, pos);
+}
+
+__attribute__((target("avx2")))
+inline size_t scanWhitespaceAVX2(const char* data, size_t size, size_t pos) {
+    while (pos + 32 <= size) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i isSpace = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' '));
+        __m256i shifted = _mm256_sub_epi8(chunk, _mm256_set1_epi8('\t'));
+        __m256i isCtrl = _mm256_cmpeq_epi8(_mm256_subs_epu8(shifted, _mm256_set1_epi8(4)),
+                                           _mm256_setzero_si256());
+        unsigned wsMask = _mm256_movemask_epi8(_mm256_or_si256(isSpace, isCtrl));
+        unsigned nonWs = ~wsMask;
+        if (nonWs != 0) {
+            return pos + __builtin_ctz(nonWs);
+        }
+        pos += 32;
+    }
+    return scanWhitespaceSSE2(data, size, pos);
+}
+
+__attribute__((target("avx2")))
+inline size_t scanStringAVX2(const char* data, size_t size, size_t pos) {
+    while (pos + 32 <= size) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+                                          _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+        unsigned mask = _mm256_movemask_epi8(special);
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 32;
+    }
+    return scanStringSSE2(data, size, pos);
+}
+
+__attribute__((target("avx2")))
+inline size_t scanEscapeAVX2(const char* data, size_t size, size_t pos) {
+    while (pos + 32 <= size) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+                                          _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+        __m256i isCtrl = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, _mm256_set1_epi8(0x1F)),
+                                           _mm256_set1_epi8(0x1F));
+        unsigned mask = _mm256_movemask_epi8(_mm256_or_si256(special, isCtrl));
+        if (mask != 0) {
+            return pos + __builtin_ctz(mask);
+        }
+        pos += 32;
+    }
+    return scanEscapeSSE2(data, size, pos);
+}
+
+// Picked once at startup; SSE2 is the x86-64 baseline
+inline const auto scanWhitespaceImpl = __builtin_cpu_supports("avx2") ? scanWhitespaceAVX2 : scanWhitespaceSSE2;
+inline const auto scanStringImpl = __builtin_cpu_supports("avx2") ? scanStringAVX2 : scanStringSSE2;
+inline const auto scanEscapeImpl = __builtin_cpu_supports("avx2") ? scanEscapeAVX2 : scanEscapeSSE2;
+
+#elif defined(__ARM_NEON)
+
+inline size_t scanWhitespaceNEON(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        uint8x16_t isSpace = vceqq_u8(chunk, vdupq_n_u8(' '));
+        uint8x16_t isCtrl = vcleq_u8(vsubq_u8(chunk, vdupq_n_u8('\t')), vdupq_n_u8(4));
+        uint8x16_t ws = vorrq_u8(isSpace, isCtrl);
+        // Narrow each 16-bit lane pair to a nibble to get a 64-bit mask
+        uint64_t wsMask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(ws), 4)), 0);
+        uint64_t nonWs = ~wsMask;
+        if (nonWs != 0) {
+            return pos + (__builtin_ctzll(nonWs) >> 2);
+        }
+        pos += 16;
+    }
+    return scanWhitespaceScalar(data, size, pos);
+}
+
+inline size_t scanStringNEON(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        uint8x16_t special = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('"')),
+                                      vceqq_u8(chunk, vdupq_n_u8('\\')));
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+        if (mask != 0) {
+            return pos + (__builtin_ctzll(mask) >> 2);
+        }
+        pos += 16;
+    }
+    return scanStringScalar(data, size, pos);
+}
+
+inline size_t scanEscapeNEON(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+        uint8x16_t special = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('"')),
+                                      vceqq_u8(chunk, vdupq_n_u8('\\')));
+        special = vorrq_u8(special, vcltq_u8(chunk, vdupq_n_u8(0x20)));
+        uint64_t mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+        if (mask != 0) {
+            return pos + (__builtin_ctzll(mask) >> 2);
+        }
+        pos += 16;
+    }
+    return scanEscapeScalar(data, size, pos);
+}
+
+inline const auto scanWhitespaceImpl = scanWhitespaceNEON;
+inline const auto scanStringImpl = scanStringNEON;
+inline const auto scanEscapeImpl = scanEscapeNEON;
+
+#else
+
+inline const auto scanWhitespaceImpl = scanWhitespaceScalar;
+inline const auto scanStringImpl = scanStringScalar;
+inline const auto scanEscapeImpl = scanEscapeScalar;
+
+#endif
+
+// True when `text` is well-formed UTF-8. ASCII runs -- the bulk of most
+// JSON -- are cleared sixteen bytes at a time at the same width as the
+// scan kernels; only blocks containing a high byte decode the
+// multi-byte sequences, which rejects stray continuation bytes,
+// overlong forms, surrogates and code points past U+10FFFF.
+inline bool validateUtf8(std::string_view text) {
+    const char* data = text.data();
+    size_t size = text.size();
+    size_t pos = 0;
+    while (pos < size) {
+#if defined(__x86_64__) || defined(__i386__)
+        while (pos + 16 <= size) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            if (_mm_movemask_epi8(chunk) != 0) {
+                break;
+            }
+            pos += 16;
+        }
+#elif defined(__ARM_NEON)
+        while (pos + 16 <= size) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(data + pos));
+            if (vmaxvq_u8(chunk) >= 0x80) {
+                break;
+            }
+            pos += 16;
+        }
+#endif
+        if (pos >= size) {
+            break;
+        }
+        unsigned char lead = static_cast<unsigned char>(data[pos]);
+        if (lead < 0x80) {
+            pos++;
+            continue;
+        }
+        size_t length;
+        uint32_t codePoint;
+        uint32_t minimum;
+        if ((lead & 0xE0) == 0xC0) {
+            length = 2; codePoint = lead & 0x1F; minimum = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3; codePoint = lead & 0x0F; minimum = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4; codePoint = lead & 0x07; minimum = 0x10000;
+        } else {
+            return false; // stray continuation byte or invalid lead
+        }
+        if (pos + length > size) {
+            return false;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            unsigned char cont = static_cast<unsigned char>(data[pos + i]);
+            if ((cont & 0xC0) != 0x80) {
+                return false;
+            }
+            codePoint = (codePoint << 6) | (cont & 0x3F);
+        }
+        if (codePoint < minimum || codePoint > 0x10FFFF ||
+            (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return false;
+        }
+        pos += length;
+    }
+    return true;
+}
+
+
+// ---- Shared lexing helpers ----
+// Token-level routines used by both the DOM parser and the streaming
+// parser, so the two stay byte-for-byte compatible.
+
+inline char consumeChar(std::string_view input, size_t& position) {
+    if (position >= input.size()) {
+        throw std::runtime_error("Unexpected end of input at position " + std::to_string(position));
+    }
+    return input[position++];
+}
+
+// Four hex digits to a UTF-16 code unit, or -1 when a digit is missing
+// or not hex. Each nibble decodes arithmetically ((d & 0xF) + 9 * (d >> 6)
+// works because letters have bit 6 set and digits do not) instead of
+// through the std::string + std::stoul round trip this used to make.
+inline int lexHex4(std::string_view input, size_t& position) {
+    if (position + 4 > input.size()) {
+        return -1;
+    }
+    unsigned value = 0;
+    bool valid = true;
+    for (int i = 0; i < 4; ++i) {
+        unsigned char digit = static_cast<unsigned char>(input[position + i]);
+        valid &= std::isxdigit(digit) != 0;
+        value = (value << 4) | ((digit & 0xFu) + 9u * (digit >> 6));
+    }
+    if (!valid) {
+        return -1;
+    }
+    position += 4;
+    return static_cast<int>(value);
+}
+
+// Decode the body of one \uXXXX escape (the backslash and 'u' already
+// consumed) into a code point, combining a UTF-16 surrogate pair into
+// the supplementary-plane character it denotes. Lone surrogates are
+// rejected; encoding them would produce invalid UTF-8.
+inline uint32_t lexUnicodeEscape(std::string_view input, size_t& position) {
+    int unit = lexHex4(input, position);
+    if (unit < 0) {
+        throw std::runtime_error("Invalid Unicode escape sequence");
+    }
+    if (unit >= 0xD800 && unit <= 0xDBFF) {
+        if (position + 1 >= input.size() || input[position] != '\\' || input[position + 1] != 'u') {
+            throw std::runtime_error("Unpaired surrogate in Unicode escape");
+        }
+        position += 2;
+        int low = lexHex4(input, position);
+        if (low < 0) {
+            throw std::runtime_error("Invalid Unicode escape sequence");
+        }
+        if (low < 0xDC00 || low > 0xDFFF) {
+            throw std::runtime_error("Unpaired surrogate in Unicode escape");
+        }
+        return 0x10000u + ((static_cast<uint32_t>(unit) - 0xD800u) << 10) +
+               (static_cast<uint32_t>(low) - 0xDC00u);
+    }
+    if (unit >= 0xDC00 && unit <= 0xDFFF) {
+        throw std::runtime_error("Unpaired surrogate in Unicode escape");
+    }
+    return static_cast<uint32_t>(unit);
+}
+
+// Encode one code point as UTF-8 (1-4 bytes) onto the end of `out`
+inline void appendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint <= 0x7F) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint <= 0x7FF) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint <= 0xFFFF) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+// Raw extent of one string token starting at the opening quote: the
+// span between the quotes, undecoded, plus whether any escape occurred
+struct RawStringToken {
+    std::string_view raw;
+    bool escaped;
+};
+
+inline RawStringToken lexRawString(std::string_view input, size_t& position) {
+    consumeChar(input, position); // Consume '"'
+    size_t start = position;
+    bool escaped = false;
+    // Fast path: most strings contain no escapes, so scan to the closing
+    // quote first and avoid touching the contents byte by byte
+    while (true) {
+        position = scanStringImpl(input.data(), input.size(), position);
+        if (position >= input.size()) {
+            throw std::runtime_error("Unterminated string");
+        }
+        if (input[position] == '"') {
+            break;
+        }
+        escaped = true;
+        position += 2; // the backslash plus the character it escapes
+    }
+    RawStringToken token{input.substr(start, position - start), escaped};
+    position++; // Consume '"'
+    return token;
+}
+
+// Decode the escapes in a raw string span (bare quotes cannot appear)
+inline std::string decodeStringEscapes(std::string_view raw) {
+    std::string result;
+    result.reserve(raw.size());
+    size_t position = 0;
+    while (position < raw.size()) {
+        size_t next = scanStringImpl(raw.data(), raw.size(), position);
+        result.append(raw, position, next - position);
+        position = next;
+        if (position >= raw.size()) {
+            break;
+        }
+        position++; // the backslash
+        char escaped = consumeChar(raw, position);
+        if (escaped == '"') result += '"';
+        else if (escaped == '\\') result += '\\';
+        else if (escaped == '/') result += '/';
+        else if (escaped == 'b') result += '\b';
+        else if (escaped == 'f') result += '\f';
+        else if (escaped == 'n') result += '\n';
+        else if (escaped == 'r') result += '\r';
+        else if (escaped == 't') result += '\t';
+        else if (escaped == 'u') {
+            appendUtf8(result, lexUnicodeEscape(raw, position));
+        } else {
+            throw std::runtime_error("Invalid escape character");
+        }
+    }
+    return result;
+}
+
+// One fully decoded string token. When the contents are escape-free,
+// `text` aliases the input buffer; otherwise `owned` holds the decoded
+// bytes and `text` points at it.
+struct StringToken {
+    std::string owned;
+    std::string_view text;
+    bool escaped;
+};
+
+inline StringToken lexString(std::string_view input, size_t& position) {
+    RawStringToken raw = lexRawString(input, position);
+    StringToken token;
+    token.escaped = raw.escaped;
+    if (raw.escaped) {
+        token.owned = decodeStringEscapes(raw.raw);
+        token.text = token.owned;
+    } else {
+        token.text = raw.raw;
+    }
+    return token;
+}
+
+inline std::string_view lexRawNumber(std::string_view input, size_t& position) {
+    size_t start = position;
+    while (position < input.size() &&
+           (std::isdigit(input[position]) || input[position] == '.' ||
+            input[position] == '-' || input[position] == '+' ||
+            input[position] == 'e' || input[position] == 'E')) {
+        position++;
+    }
+    return input.substr(start, position - start);
+}
+
+// from_chars parses in place: no substr allocation, no locale lookup
+inline double parseNumberText(std::string_view text) {
+    double value = 0.0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) {
+        throw std::runtime_error("Invalid number: " + std::string(text));
+    }
+    return value;
+}
+
+inline double lexNumber(std::string_view input, size_t& position) {
+    return parseNumberText(lexRawNumber(input, position));
+}
+
+// Step past one value in already-validated (or at least well-formed)
+// text using only the scan kernels: strings via the raw lexer, nesting
+// via a depth counter, scalars by running to the next structural byte
+inline void skipValueTokens(std::string_view text, size_t& pos) {
+    size_t depth = 0;
+    do {
+        if (pos >= text.size()) {
+            throw std::runtime_error("Unexpected end of input at position " + std::to_string(pos));
+        }
+        char current = text[pos];
+        if (current == '"') {
+            lexRawString(text, pos);
+        } else if (current == '{' || current == '[') {
+            depth++;
+            pos++;
+        } else if (current == '}' || current == ']') {
+            if (depth == 0) {
+                // a closer where a value should start; without this the
+                // size_t underflows and the loop scans to end of input
+                throw std::runtime_error("Invalid JSON value");
+            }
+            depth--;
+            pos++;
+        } else if (current == ',' || current == ':') {
+            pos++;
+        } else if (std::isspace(static_cast<unsigned char>(current))) {
+            pos = scanWhitespaceImpl(text.data(), text.size(), pos);
+        } else {
+            // number or literal: run to the next structural byte
+            while (pos < text.size() && text[pos] != ',' && text[pos] != '}' &&
+                   text[pos] != ']' &&
+                   !std::isspace(static_cast<unsigned char>(text[pos]))) {
+                pos++;
+            }
+        }
+    } while (depth > 0 && pos < text.size());
+}
+
+// ---- Lazy scalar materialization ----
+// First access converts an undecoded span (or borrowed view being
+// written through) into the owned form and caches it in the node.
+
+inline void JSONValue::materialize() const {
+    if (auto* raw = std::get_if<RawString>(&data)) {
+        std::string decoded = decodeStringEscapes(raw->raw);
+        data = std::move(decoded);
+    } else if (auto* raw = std::get_if<RawNumber>(&data)) {
+        data = parseNumberText(raw->text);
+    }
+}
+
+inline std::string& JSONValue::stringValue() {
+    materialize();
+    if (auto* sv = std::get_if<std::string_view>(&data)) {
+        data = std::string(*sv);
+    }
+    return std::get<std::string>(data);
+}
+
+inline const std::string& JSONValue::stringValue() const {
+    materialize();
+    // A borrowed view caches as owned text here too -- the variant is
+    // mutable precisely so const reads can fill it in
+    if (auto* sv = std::get_if<std::string_view>(&data)) {
+        data = std::string(*sv);
+    }
+    return std::get<std::string>(data);
+}
+
+inline std::string_view JSONValue::stringView() const {
+    materialize();
+    if (auto* sv = std::get_if<std::string_view>(&data)) {
+        return *sv;
+    }
+    return std::get<std::string>(data);
+}
+
+inline double& JSONValue::numberValue() {
+    materialize();
+    return std::get<double>(data);
+}
+
+inline double JSONValue::numberValue() const {
+    materialize();
+    return std::get<double>(data);
+}
+
+// Shortest round-trip number formatting via to_chars; std::to_string
+// printed six fixed decimals, both losing precision and wasting bytes.
+inline void appendNumber(std::string& out, double value) {
+    char digits[32];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, end);
+}
+
+// Append `text` as the body of a JSON string, escaping quotes,
+// backslashes and control characters. Clean runs are located with the
+// vectorized classifier and copied in bulk, so escape-free strings (the
+// overwhelming majority) cost one scan plus one append.
+inline void appendEscaped(std::string& out, std::string_view text) {
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t next = scanEscapeImpl(text.data(), text.size(), position);
+        out.append(text, position, next - position);
+        position = next;
+        if (position >= text.size()) {
+            break;
+        }
+        char escaped = text[position++];
+        switch (escaped) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: { // remaining control characters: \u00XX
+                static constexpr char hex[] = "0123456789abcdef";
+                out += "\\u00";
+                out += hex[(escaped >> 4) & 0xF];
+                out += hex[escaped & 0xF];
+            }
+        }
+    }
+}
+
+// ---- Typed extraction ----
+// Consumers that map fixed record shapes into C++ structs pay for the
+// DOM — maps, vectors, type tags — only to copy fields out of it again.
+// A JSONBinding describes where each key lands in the struct (member
+// pointers, dispatched with if constexpr per member type), and
+// JSONParser::parseInto fills the struct straight off the tokenizer,
+// never constructing a JSONValue. Unknown keys are skipped at token
+// level; keys with escapes in the input do not match bindings.
+template <typename Record>
+class JSONBinding {
+public:
+    using Member = std::variant<double Record::*, int Record::*, bool Record::*,
+                                std::string Record::*>;
+    struct Field {
+        std::string key;
+        Member member;
+    };
+
+    JSONBinding& field(std::string key, double Record::* member) {
+        fields.push_back(Field{std::move(key), member});
+        return *this;
+    }
+    JSONBinding& field(std::string key, int Record::* member) {
+        fields.push_back(Field{std::move(key), member});
+        return *this;
+    }
+    JSONBinding& field(std::string key, bool Record::* member) {
+        fields.push_back(Field{std::move(key), member});
+        return *this;
+    }
+    JSONBinding& field(std::string key, std::string Record::* member) {
+        fields.push_back(Field{std::move(key), member});
+        return *this;
+    }
+
+    // Bindings hold a handful of fields, so lookup scans linearly — the
+    // same tradeoff small JSONObjects make
+    const Field* find(std::string_view key) const {
+        for (const Field& entry : fields) {
+            if (entry.key == key) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    std::vector<Field> fields;
+};
+
+// ---- Parse statistics (opt-in) ----
+// Define JSON_PARSER_STATS before including this header to have
+// JSONParser count what it does; the default build compiles every hook
+// away, so the hot paths carry zero overhead unless asked. The counters
+// attribute throughput changes to payload shape — string-heavy versus
+// numeric, deep versus flat, copied versus viewed — without attaching a
+// profiler to a live box.
+struct ParseStats {
+    size_t bytesScanned = 0;
+    size_t objects = 0;
+    size_t arrays = 0;
+    size_t strings = 0;
+    size_t numbers = 0;
+    size_t booleans = 0;
+    size_t nulls = 0;
+    size_t stringBytesCopied = 0; // decoded or duplicated into the tree
+    size_t stringBytesViewed = 0; // zero-copy or lazy spans
+    size_t allocations = 0;       // container allocations via the parser's resource
+    size_t peakDepth = 0;
+    double parseSeconds = 0.0;
+
+    // One line, ready for a log file
+    std::string report() const {
+        std::ostringstream out;
+        out << "parsed " << bytesScanned << "B in "
+            << std::fixed << std::setprecision(3) << parseSeconds * 1e3 << "ms"
+            << " (" << (parseSeconds > 0 ? bytesScanned / parseSeconds / (1 << 20) : 0.0) << " MB/s):"
+            << " obj=" << objects << " arr=" << arrays
+            << " str=" << strings << " num=" << numbers
+            << " bool=" << booleans << " null=" << nulls
+            << " strB=" << stringBytesCopied << "c/" << stringBytesViewed << "v"
+            << " alloc=" << allocations << " depth=" << peakDepth;
+        return out.str();
+    }
+};
+
+#ifdef JSON_PARSER_STATS
+#define JSON_STATS(expr) do { expr; } while (false)
+#else
+#define JSON_STATS(expr) do { } while (false)
+#endif
+
+// Compile-time parser policy. Every flag is constexpr, so an
+// instantiation of BasicJSONParser only contains the branches its
+// deployment actually takes -- a strict ingest service and a lenient
+// config loader each get a dedicated kernel instead of sharing one
+// generic dispatch that tests every knob per token. The defaults
+// reproduce the behavior JSONParser has always had. Comment support
+// applies to the DOM engines; the chunk-feed and SAX paths keep the
+// plain grammar.
+struct JSONParserOptions {
+    static constexpr bool borrowStrings = true;       // views into caller buffers in zero-copy mode
+    static constexpr bool lazyScalars = false;        // start in lazy mode (see setLazy)
+    static constexpr bool validateUtf8Strings = false; // start with the UTF-8 pass on (see setValidateUtf8)
+    static constexpr bool allowTrailingCommas = true; // in arrays; objects always reject them
+    static constexpr bool allowDuplicateKeys = true;  // last assignment wins
+    static constexpr bool allowComments = false;      // treat // and /* */ as whitespace
+};
+
+template <class Options = JSONParserOptions>
+class BasicJSONParser {
+private:
+    std::string ownedInput;     // empty in zero-copy mode
+    std::string_view input;
+    size_t position;
+    std::pmr::memory_resource* memory;
+    bool borrowed;              // strings may alias the input buffer
+    bool lazy = Options::lazyScalars;          // record scalar spans, decode on access
+    bool checkUtf8 = Options::validateUtf8Strings; // validate raw string spans while parsing
+    size_t maxDepth = 1024;     // nesting cap for the iterative engine
+
+    // Object keys repeat massively in record-shaped data (millions of
+    // telemetry objects sharing the same dozen keys), so each key is
+    // decoded once and cached here; repeats skip the lexer's escape
+    // decoding and, for keys past the small-string threshold, copy from
+    // a warm allocation instead of re-deriving one from the input. The
+    // set owns its key text (looked up transparently by span), so it
+    // survives reset() swapping the input buffer out from under it.
+    // Nodes come from the parser's memory resource, so arena mode pools
+    // them with the rest of the tree.
+    struct TransparentHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+    std::pmr::unordered_set<std::string, TransparentHash, std::equal_to<>> internedKeys{memory};
+
+    const std::string& internKey(const RawStringToken& token) {
+        if (checkUtf8 && !validateUtf8(token.raw)) {
+            throw std::runtime_error("Invalid UTF-8 in string");
+        }
+        if (token.escaped) {
+            return *internedKeys.insert(decodeStringEscapes(token.raw)).first;
+        }
+        auto it = internedKeys.find(token.raw);
+        if (it == internedKeys.end()) {
+            it = internedKeys.emplace(token.raw).first;
+        }
+        return *it;
+    }
+
+#ifdef JSON_PARSER_STATS
+    ParseStats parseStats;
+
+    // Wraps the configured resource so container allocations are counted
+    struct CountingResource : std::pmr::memory_resource {
+        std::pmr::memory_resource* upstream;
+        size_t* allocations;
+        CountingResource(std::pmr::memory_resource* up, size_t* counter)
+            : upstream(up), allocations(counter) {}
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++*allocations;
+            return upstream->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            upstream->deallocate(p, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+    CountingResource counting{memory, &parseStats.allocations};
+#endif
+
+    char peek() {
+        return position < input.size() ? input[position] : '\0';
+    }
+
+    char consume() {
+        if (position >= input.size()) {
+            throw std::runtime_error("Unexpected end of input at position " + std::to_string(position));
+        }
+        return input[position++];
+    }
+
+    void skipWhitespace() {
+        position = scanWhitespaceImpl(input.data(), input.size(), position);
+        if constexpr (Options::allowComments) {
+            while (position + 1 < input.size() && input[position] == '/') {
+                if (input[position + 1] == '/') {
+                    position = input.find('\n', position + 2);
+                    if (position == std::string_view::npos) {
+                        position = input.size();
+                        return;
+                    }
+                } else if (input[position + 1] == '*') {
+                    size_t close = input.find("*/", position + 2);
+                    if (close == std::string_view::npos) {
+                        throw std::runtime_error("Unterminated comment");
+                    }
+                    position = close + 2;
+                } else {
+                    return; // a lone '/' is left for the value parser to reject
+                }
+                position = scanWhitespaceImpl(input.data(), input.size(), position);
+            }
+        }
+    }
+
+    JSONValue parseValue();
+    JSONValue parseObject();
+    JSONValue parseArray();
+    JSONValue parseScalar();
+    JSONValue parseValueIterative();
+
+    std::vector<std::pair<size_t, size_t>> splitTopLevel() const;
+
+    JSONValue parseString();
+    JSONValue parseNumber();
+    JSONValue parseLiteral(const std::string& literal, JSONValue value);
+
+    // ---- Incremental (chunk-feed) parsing ----
+    // Persistent engine state between feed() calls: the same frames as
+    // parseValueIterative plus an explicit "what token comes next" step,
+    // so a chunk boundary can fall anywhere, including mid-token.
+    struct StreamFrame {
+        JSONValue container;
+        std::string pendingKey;
+        bool isObject;
+        bool first = true;
+    };
+    enum class StreamStep { Value, KeyOrClose, Colon, CommaOrClose, Done };
+    struct StreamState {
+        std::string buffer;   // unconsumed input; compacted as it drains
+        size_t pos = 0;
+        std::vector<StreamFrame> stack;
+        JSONValue root;
+        StreamStep step = StreamStep::Value;
+    };
+    std::unique_ptr<StreamState> stream;
+
+    void pumpStream(bool final);
+
+public:
+    explicit BasicJSONParser(std::string json)
+        : ownedInput(std::move(json)), input(ownedInput), position(0),
+          memory(std::pmr::get_default_resource()), borrowed(false) {}
+
+    // Arena-backed mode: the parse tree's containers all come out of the
+    // arena, making teardown a bulk release instead of a recursive free
+    BasicJSONParser(std::string json, JSONArena& arena)
+        : ownedInput(std::move(json)), input(ownedInput), position(0),
+          memory(arena.resource()), borrowed(false) {}
+
+    // Zero-copy mode: the caller keeps the buffer alive and escape-free
+    // strings become views into it instead of fresh allocations
+    explicit BasicJSONParser(std::string_view json)
+        : input(json), position(0),
+          memory(std::pmr::get_default_resource()), borrowed(true) {}
+
+    BasicJSONParser(std::string_view json, JSONArena& arena)
+        : input(json), position(0), memory(arena.resource()), borrowed(true) {}
+
+    // Streaming mode: construct without input, then feed() chunks as
+    // they arrive off the wire and call finish() once the stream ends.
+    // The DOM grows as complete tokens land, so parsing overlaps I/O
+    // instead of waiting for the whole body to be buffered.
+    BasicJSONParser()
+        : position(0), memory(std::pmr::get_default_resource()), borrowed(false) {}
+
+    explicit BasicJSONParser(JSONArena& arena)
+        : position(0), memory(arena.resource()), borrowed(false) {}
+
+    void feed(const char* data, size_t size);
+    JSONValue finish();
+
+    // Re-arm this parser for another document while keeping everything
+    // already warm: the key intern table, the memory resource, and the
+    // lazy/depth settings. Zero-copy semantics, same contract as the
+    // string_view constructor: the caller keeps the buffer alive.
+    void reset(std::string_view json) {
+        ownedInput.clear();
+        input = json;
+        position = 0;
+        borrowed = true;
+        stream.reset();
+    }
+
+    // Parse a batch of documents through one warm parser, touching the
+    // next document's first cache line while the current one finishes
+    std::vector<JSONValue> parseMany(const std::vector<std::string_view>& documents) {
+        std::vector<JSONValue> results;
+        results.reserve(documents.size());
+        for (size_t i = 0; i < documents.size(); ++i) {
+            if (i + 1 < documents.size() && !documents[i + 1].empty()) {
+                __builtin_prefetch(documents[i + 1].data());
+            }
+            reset(documents[i]);
+            results.push_back(parse());
+        }
+        return results;
+    }
+
+    // Lazy mode: scalars keep their token spans and are only decoded
+    // when first read through a JSONValue accessor. The input buffer
+    // (or this parser, in the owning modes) must outlive the document.
+    void setLazy(bool on) { lazy = on; }
+
+    // Optional pass: reject strings whose bytes are not well-formed
+    // UTF-8. Off by default; the grammar itself never needs it.
+    void setValidateUtf8(bool on) { checkUtf8 = on; }
+
+    // Nesting beyond this raises a runtime_error instead of overflowing
+    // the thread stack
+    void setMaxDepth(size_t depth) { maxDepth = depth; }
+
+    JSONValue parse();
+    JSONValue parseRecursive();
+    JSONValue parseParallel(size_t nThreads = std::thread::hardware_concurrency());
+
+#ifdef JSON_PARSER_STATS
+    // Counters accumulated across every parse this parser has run
+    const ParseStats& stats() const { return parseStats; }
+#endif
+
+    // Fill one record struct from a top-level object, writing bound
+    // members directly from the tokenizer
+    template <typename Record>
+    void parseInto(const JSONBinding<Record>& binding, Record& out) {
+        skipWhitespace();
+        parseRecordInto(binding, out);
+        skipWhitespace();
+        if (position != input.size()) {
+            throw std::runtime_error("Unexpected characters at end of JSON input");
+        }
+    }
+
+    // Fill one record per element of a top-level array of objects — the
+    // telemetry shape the DOM path pays the most for
+    template <typename Record>
+    std::vector<Record> parseArrayInto(const JSONBinding<Record>& binding) {
+        std::vector<Record> records;
+        skipWhitespace();
+        if (consume() != '[') {
+            throw std::runtime_error("Typed extraction expects an array of records");
+        }
+        skipWhitespace();
+        while (peek() != ']') {
+            skipWhitespace();
+            records.emplace_back();
+            parseRecordInto(binding, records.back());
+            skipWhitespace();
+            if (peek() == ',') {
+                consume(); // Consume ','
+                skipWhitespace();
+            } else if (peek() != ']') {
+                throw std::runtime_error("Expected ',' or ']' in array");
+            }
+        }
+        consume(); // Consume ']'
+        skipWhitespace();
+        if (position != input.size()) {
+            throw std::runtime_error("Unexpected characters at end of JSON input");
+        }
+        return records;
+    }
+
+private:
+    template <typename Record>
+    void parseRecordInto(const JSONBinding<Record>& binding, Record& out) {
+        skipWhitespace();
+        if (consume() != '{') {
+            throw std::runtime_error("Typed extraction expects an object record");
+        }
+        skipWhitespace();
+        if (peek() == '}') {
+            consume(); // Consume '}'
+            return;
+        }
+        while (true) {
+            skipWhitespace();
+            if (peek() != '"') {
+                throw std::runtime_error("Expected string key in object");
+            }
+            RawStringToken key = lexRawString(input, position);
+            skipWhitespace();
+            if (consume() != ':') {
+                throw std::runtime_error("Expected ':' in object");
+            }
+            skipWhitespace();
+            const auto* field = key.escaped ? nullptr : binding.find(key.raw);
+            if (field) {
+                applyField(*field, out);
+            } else {
+                skipValueTokens(input, position);
+            }
+            skipWhitespace();
+            if (peek() == ',') {
+                consume(); // Consume ','
+                continue;
+            }
+            if (consume() == '}') {
+                return;
+            }
+            throw std::runtime_error("Expected ',' or '}' in object");
+        }
+    }
+
+    template <typename Record>
+    void applyField(const typename JSONBinding<Record>::Field& field, Record& out) {
+        char current = peek();
+        std::visit([&](auto member) {
+            using MemberPtr = std::decay_t<decltype(member)>;
+            if constexpr (std::is_same_v<MemberPtr, std::string Record::*>) {
+                if (current != '"') {
+                    throw std::runtime_error("Type mismatch for field '" + field.key + "'");
+                }
+                StringToken token = lexString(input, position);
+                out.*member = token.escaped ? std::move(token.owned) : std::string(token.text);
+            } else if constexpr (std::is_same_v<MemberPtr, bool Record::*>) {
+                if (input.compare(position, 4, "true") == 0) {
+                    out.*member = true;
+                    position += 4;
+                } else if (input.compare(position, 5, "false") == 0) {
+                    out.*member = false;
+                    position += 5;
+                } else {
+                    throw std::runtime_error("Type mismatch for field '" + field.key + "'");
+                }
+            } else {
+                if (!std::isdigit(current) && current != '-') {
+                    throw std::runtime_error("Type mismatch for field '" + field.key + "'");
+                }
+                using Value = std::remove_reference_t<decltype(out.*member)>;
+                out.*member = static_cast<Value>(lexNumber(input, position));
+            }
+        }, field.member);
+    }
+};
+
+// The default instantiation is what this file and existing callers mean
+// by "the parser"; deployments wanting a specialized kernel instantiate
+// BasicJSONParser with their own options struct.
+using JSONParser = BasicJSONParser<>;
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parse() {
+#ifdef JSON_PARSER_STATS
+    memory = &counting;
+    auto statsBegin = std::chrono::steady_clock::now();
+#endif
+    skipWhitespace();
+    JSONValue result = parseValueIterative();
+    skipWhitespace();
+    if (position != input.size()) {
+        throw std::runtime_error("Unexpected characters at end of JSON input");
+    }
+#ifdef JSON_PARSER_STATS
+    parseStats.parseSeconds +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - statsBegin).count();
+    parseStats.bytesScanned += position;
+#endif
+    return result;
+}
+
+// Reference path: the original recursive engine. Kept for comparison and
+// debugging; it has no depth guard, so adversarial nesting can overflow
+// the thread stack.
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseRecursive() {
+    skipWhitespace();
+    JSONValue result = parseValue();
+    skipWhitespace();
+    if (position != input.size()) {
+        throw std::runtime_error("Unexpected characters at end of JSON input");
+    }
+    return result;
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseScalar() {
+    char current = peek();
+    if (current == '"') return parseString();
+    if (std::isdigit(current) || current == '-') return parseNumber();
+    if (input.compare(position, 4, "true") == 0) {
+        JSON_STATS(parseStats.booleans++);
+        return parseLiteral("true", JSONValue(true));
+    }
+    if (input.compare(position, 5, "false") == 0) {
+        JSON_STATS(parseStats.booleans++);
+        return parseLiteral("false", JSONValue(false));
+    }
+    if (input.compare(position, 4, "null") == 0) {
+        JSON_STATS(parseStats.nulls++);
+        return parseLiteral("null", JSONValue());
+    }
+
+    throw std::runtime_error("Invalid JSON value");
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseValue() {
+    skipWhitespace();
+    char current = peek();
+    if (current == '{') return parseObject();
+    if (current == '[') return parseArray();
+    return parseScalar();
+}
+
+// Iterative engine: one explicit frame per open container instead of one
+// native stack frame per nesting level, so depth is limited by maxDepth,
+// not by the thread stack. All engines, the recursive reference path
+// included, accept the same grammar: a trailing comma is tolerated in
+// arrays (under the default options) and always rejected in objects.
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseValueIterative() {
+    struct Frame {
+        JSONValue container;
+        std::string pendingKey;
+        bool isObject;
+        bool first = true;
+    };
+    std::vector<Frame> stack;
+    JSONValue completed;
+    bool haveValue = false;
+
+    while (true) {
+        if (!haveValue) {
+            if (!stack.empty() && stack.back().isObject) {
+                skipWhitespace();
+                if (peek() == '}' && stack.back().first) {
+                    consume(); // Consume '}'
+                    completed = std::move(stack.back().container);
+                    stack.pop_back();
+                    haveValue = true;
+                    continue;
+                }
+                if (peek() != '"') {
+                    throw std::runtime_error("Expected string key in object");
+                }
+                RawStringToken key = lexRawString(input, position);
+                skipWhitespace();
+                if (consume() != ':') {
+                    throw std::runtime_error("Expected ':' in object");
+                }
+                stack.back().pendingKey = internKey(key);
+                if constexpr (!Options::allowDuplicateKeys) {
+                    if (stack.back().container.objectValue().count(stack.back().pendingKey)) {
+                        throw std::runtime_error("Duplicate key in object: " + stack.back().pendingKey);
+                    }
+                }
+            } else if (!stack.empty()) {
+                skipWhitespace();
+                if (peek() == ']') {
+                    if constexpr (!Options::allowTrailingCommas) {
+                        if (!stack.back().first) {
+                            throw std::runtime_error("Trailing comma in array");
+                        }
+                    }
+                    consume(); // Consume ']'
+                    completed = std::move(stack.back().container);
+                    stack.pop_back();
+                    haveValue = true;
+                    continue;
+                }
+            }
+            skipWhitespace();
+            char current = peek();
+            if (current == '{' || current == '[') {
+                consume(); // Consume the opener
+                if (stack.size() >= maxDepth) {
+                    throw std::runtime_error("Maximum nesting depth exceeded");
+                }
+                bool isObject = current == '{';
+                stack.push_back(Frame{
+                    JSONValue(isObject ? JSONValue::Type::OBJECT : JSONValue::Type::ARRAY, memory),
+                    {}, isObject});
+                JSON_STATS(isObject ? parseStats.objects++ : parseStats.arrays++);
+                JSON_STATS(parseStats.peakDepth = std::max(parseStats.peakDepth, stack.size()));
+                continue;
+            }
+            completed = parseScalar();
+            haveValue = true;
+            continue;
+        }
+
+        if (stack.empty()) {
+            return completed;
+        }
+        Frame& top = stack.back();
+        if (top.isObject) {
+            top.container.objectValue()[std::move(top.pendingKey)] = std::move(completed);
+        } else {
+            top.container.arrayValue().emplace_back(std::move(completed));
+        }
+        top.first = false;
+        skipWhitespace();
+        char current = peek();
+        if (current == ',') {
+            consume(); // Consume ','
+            haveValue = false;
+            continue;
+        }
+        if (top.isObject ? current == '}' : current == ']') {
+            consume(); // Consume the closer
+            completed = std::move(top.container);
+            stack.pop_back();
+            continue;
+        }
+        throw std::runtime_error(top.isObject ? "Expected ',' or '}' in object"
+                                              : "Expected ',' or ']' in array");
+    }
+}
+
+// Feed one chunk of input to the streaming engine. Structure that is
+// complete so far goes into the DOM immediately; a token cut off by the
+// chunk boundary stays buffered until the bytes finishing it arrive.
+template <class Options>
+void BasicJSONParser<Options>::feed(const char* data, size_t size) {
+    if (!stream) {
+        stream = std::make_unique<StreamState>();
+    }
+    stream->buffer.append(data, size);
+    pumpStream(false);
+    // Drop the consumed prefix so a long stream costs window-sized
+    // memory, not body-sized
+    if (stream->pos > 4096) {
+        stream->buffer.erase(0, stream->pos);
+        stream->pos = 0;
+    }
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::finish() {
+    if (!stream) {
+        throw std::runtime_error("finish() called before feed()");
+    }
+    pumpStream(true);
+    StreamState& state = *stream;
+    state.pos = scanWhitespaceImpl(state.buffer.data(), state.buffer.size(), state.pos);
+    if (state.step != StreamStep::Done) {
+        throw std::runtime_error("Unexpected end of input at position " + std::to_string(state.pos));
+    }
+    if (state.pos != state.buffer.size()) {
+        throw std::runtime_error("Unexpected characters at end of JSON input");
+    }
+    JSONValue result = std::move(state.root);
+    stream.reset();
+    return result;
+}
+
+// Drive the streaming state machine over whatever is buffered. Each
+// iteration needs one complete token; when the buffer ends mid-token the
+// machine returns with that token unconsumed and resumes from the same
+// step on the next feed(). The grammar matches parseValueIterative
+// (trailing commas tolerated in arrays, rejected in objects). Streamed
+// strings are always decoded into owned storage, since the buffer is
+// compacted between chunks and cannot back borrowed views or lazy spans.
+template <class Options>
+void BasicJSONParser<Options>::pumpStream(bool final) {
+    StreamState& state = *stream;
+    std::string_view view;
+
+    // Scan for the quote closing the string opening at `from`; npos
+    // means the closing quote has not arrived yet
+    auto findStringEnd = [&view](size_t from) {
+        size_t scan = from + 1;
+        while (true) {
+            scan = scanStringImpl(view.data(), view.size(), scan);
+            if (scan >= view.size()) {
+                return std::string_view::npos;
+            }
+            if (view[scan] == '"') {
+                return scan + 1;
+            }
+            scan += 2; // the backslash plus the character it escapes
+        }
+    };
+
+    // 1 = full match, -1 = prefix of a literal cut off by the chunk
+    // boundary, 0 = not this literal
+    auto matchLiteral = [&](std::string_view literal) {
+        if (view.compare(state.pos, literal.size(), literal) == 0) {
+            return 1;
+        }
+        std::string_view rest = view.substr(state.pos);
+        if (rest.size() < literal.size() && literal.compare(0, rest.size(), rest) == 0) {
+            return -1;
+        }
+        return 0;
+    };
+
+    auto attach = [&state](JSONValue&& value) {
+        if (state.stack.empty()) {
+            state.root = std::move(value);
+            state.step = StreamStep::Done;
+            return;
+        }
+        StreamFrame& top = state.stack.back();
+        if (top.isObject) {
+            top.container.objectValue()[std::move(top.pendingKey)] = std::move(value);
+        } else {
+            top.container.arrayValue().emplace_back(std::move(value));
+        }
+        top.first = false;
+        state.step = StreamStep::CommaOrClose;
+    };
+
+    auto closeTop = [&state, &attach]() {
+        JSONValue completed = std::move(state.stack.back().container);
+        state.stack.pop_back();
+        attach(std::move(completed));
+    };
+
+    while (true) {
+        view = state.buffer; // the buffer may have grown since last time
+        state.pos = scanWhitespaceImpl(view.data(), view.size(), state.pos);
+        if (state.pos >= view.size()) {
+            return; // need more input (or finish())
+        }
+        char current = view[state.pos];
+
+        switch (state.step) {
+            case StreamStep::Value: {
+                if (!state.stack.empty() && !state.stack.back().isObject && current == ']') {
+                    if constexpr (!Options::allowTrailingCommas) {
+                        if (!state.stack.back().first) {
+                            throw std::runtime_error("Trailing comma in array");
+                        }
+                    }
+                    state.pos++; // Consume ']'
+                    closeTop();
+                    break;
+                }
+                if (current == '{' || current == '[') {
+                    if (state.stack.size() >= maxDepth) {
+                        throw std::runtime_error("Maximum nesting depth exceeded");
+                    }
+                    state.pos++; // Consume the opener
+                    bool isObject = current == '{';
+                    state.stack.push_back(StreamFrame{
+                        JSONValue(isObject ? JSONValue::Type::OBJECT : JSONValue::Type::ARRAY, memory),
+                        {}, isObject});
+                    state.step = isObject ? StreamStep::KeyOrClose : StreamStep::Value;
+                    break;
+                }
+                if (current == '"') {
+                    if (findStringEnd(state.pos) == std::string_view::npos) {
+                        return;
+                    }
+                    StringToken token = lexString(view, state.pos);
+                    attach(JSONValue(std::string(token.text)));
+                    break;
+                }
+                if (std::isdigit(current) || current == '-') {
+                    size_t end = state.pos;
+                    while (end < view.size() &&
+                           (std::isdigit(view[end]) || view[end] == '.' ||
+                            view[end] == '-' || view[end] == '+' ||
+                            view[end] == 'e' || view[end] == 'E')) {
+                        end++;
+                    }
+                    if (end == view.size() && !final) {
+                        return; // the number may continue into the next chunk
+                    }
+                    attach(JSONValue(lexNumber(view, state.pos)));
+                    break;
+                }
+                int isTrue = matchLiteral("true");
+                int isFalse = matchLiteral("false");
+                int isNull = matchLiteral("null");
+                if (isTrue == 1) { state.pos += 4; attach(JSONValue(true)); break; }
+                if (isFalse == 1) { state.pos += 5; attach(JSONValue(false)); break; }
+                if (isNull == 1) { state.pos += 4; attach(JSONValue()); break; }
+                if (!final && (isTrue == -1 || isFalse == -1 || isNull == -1)) {
+                    return;
+                }
+                throw std::runtime_error("Invalid JSON value");
+            }
+            case StreamStep::KeyOrClose: {
+                if (current == '}' && state.stack.back().first) {
+                    state.pos++; // Consume '}'
+                    closeTop();
+                    break;
+                }
+                if (current != '"') {
+                    throw std::runtime_error("Expected string key in object");
+                }
+                if (findStringEnd(state.pos) == std::string_view::npos) {
+                    return;
+                }
+                StringToken key = lexString(view, state.pos);
+                state.stack.back().pendingKey =
+                    key.escaped ? std::move(key.owned) : std::string(key.text);
+                if constexpr (!Options::allowDuplicateKeys) {
+                    if (state.stack.back().container.objectValue().count(state.stack.back().pendingKey)) {
+                        throw std::runtime_error("Duplicate key in object: " + state.stack.back().pendingKey);
+                    }
+                }
+                state.step = StreamStep::Colon;
+                break;
+            }
+            case StreamStep::Colon: {
+                if (current != ':') {
+                    throw std::runtime_error("Expected ':' in object");
+                }
+                state.pos++; // Consume ':'
+                state.step = StreamStep::Value;
+                break;
+            }
+            case StreamStep::CommaOrClose: {
+                StreamFrame& top = state.stack.back();
+                if (current == ',') {
+                    state.pos++; // Consume ','
+                    state.step = top.isObject ? StreamStep::KeyOrClose : StreamStep::Value;
+                    break;
+                }
+                if (top.isObject ? current == '}' : current == ']') {
+                    state.pos++; // Consume the closer
+                    closeTop();
+                    break;
+                }
+                throw std::runtime_error(top.isObject ? "Expected ',' or '}' in object"
+                                                      : "Expected ',' or ']' in array");
+            }
+            case StreamStep::Done:
+                throw std::runtime_error("Unexpected characters at end of JSON input");
+        }
+    }
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseObject() {
+    consume(); // Consume '{'
+    skipWhitespace();
+    JSON_STATS(parseStats.objects++);
+    JSONValue object(JSONValue::Type::OBJECT, memory);
+
+    while (peek() != '}') {
+        skipWhitespace();
+        // Keys are plain strings; wrapping them in a JSONValue just to
+        // unwrap them again cost an extra node per member
+        if (peek() != '"') {
+            throw std::runtime_error("Expected string key in object");
+        }
+        RawStringToken key = lexRawString(input, position);
+        skipWhitespace();
+        if (consume() != ':') {
+            throw std::runtime_error("Expected ':' in object");
+        }
+        skipWhitespace();
+        JSONValue value = parseValue();
+        const std::string& keyText = internKey(key);
+        if constexpr (!Options::allowDuplicateKeys) {
+            if (object.objectValue().count(keyText)) {
+                throw std::runtime_error("Duplicate key in object: " + keyText);
+            }
+        }
+        object.objectValue()[keyText] = std::move(value);
+        skipWhitespace();
+
+        if (peek() == ',') {
+            consume(); // Consume ','
+            skipWhitespace();
+            if (peek() == '}') {
+                throw std::runtime_error("Expected string key in object");
+            }
+        } else if (peek() == '}') {
+            break;
+        } else {
+            throw std::runtime_error("Expected ',' or '}' in object");
+        }
+    }
+    consume(); // Consume '}'
+    return object;
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseArray() {
+    consume(); // Consume '['
+    skipWhitespace();
+    JSON_STATS(parseStats.arrays++);
+    JSONValue array(JSONValue::Type::ARRAY, memory);
+
+    while (peek() != ']') {
+        skipWhitespace();
+        array.arrayValue().emplace_back(parseValue());
+        skipWhitespace();
+
+        if (peek() == ',') {
+            consume(); // Consume ','
+            if constexpr (!Options::allowTrailingCommas) {
+                skipWhitespace();
+                if (peek() == ']') {
+                    throw std::runtime_error("Trailing comma in array");
+                }
+            }
+        } else if (peek() == ']') {
+            break;
+        } else {
+            throw std::runtime_error("Expected ',' or ']' in array");
+        }
+    }
+    consume(); // Consume ']'
+    return array;
+}
+
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseNumber() {
+    JSON_STATS(parseStats.numbers++);
+    if (lazy) {
+        return JSONValue(JSONValue::RawNumber{lexRawNumber(input, position)});
+    }
+    return JSONValue(lexNumber(input, position));
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseLiteral(const std::string& literal, JSONValue value) {
+    if (input.compare(position, literal.size(), literal) != 0) {
+        throw std::runtime_error("Invalid literal: " + literal);
+    }
+    position += literal.size();
+    return value;
+}
+
+// Scan the input without building anything and return the extent of each
+// top-level array element, or of each newline-delimited record when the
+// input is not an array. Strings and nesting are honored, so every range
+// is a complete JSON value that can be parsed independently. An empty
+// result means the input is not splittable.
+template <class Options>
+std::vector<std::pair<size_t, size_t>> BasicJSONParser<Options>::splitTopLevel() const {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t i = scanWhitespaceImpl(input.data(), input.size(), 0);
+    if (i >= input.size()) {
+        return ranges;
+    }
+    bool arrayMode = input[i] == '[';
+    if (arrayMode) {
+        i++;
+    }
+
+    constexpr size_t npos = std::string_view::npos;
+    size_t start = npos;
+    size_t depth = 0;
+
+    auto skipString = [&](size_t pos) {
+        pos++; // opening quote
+        while (pos < input.size()) {
+            pos = scanStringImpl(input.data(), input.size(), pos);
+            if (pos >= input.size() || input[pos] == '"') {
+                break;
+            }
+            pos += 2; // backslash plus the escaped character
+        }
+        if (pos >= input.size()) {
+            throw std::runtime_error("Unterminated string");
+        }
+        return pos; // at the closing quote
+    };
+
+    for (; i < input.size(); ++i) {
+        char c = input[i];
+        if (depth == 0) {
+            if (arrayMode && c == ',') {
+                if (start != npos) {
+                    ranges.emplace_back(start, i);
+                }
+                start = npos;
+                continue;
+            }
+            if (arrayMode && c == ']') {
+                if (start != npos) {
+                    ranges.emplace_back(start, i);
+                }
+                // Anything but whitespace after the closing bracket makes
+                // the input unsplittable, so parseParallel falls back to
+                // parse() and reports the trailing characters
+                if (scanWhitespaceImpl(input.data(), input.size(), i + 1) != input.size()) {
+                    ranges.clear();
+                }
+                return ranges;
+            }
+            if (!arrayMode && c == '\n') {
+                if (start != npos) {
+                    ranges.emplace_back(start, i);
+                }
+                start = npos;
+                continue;
+            }
+        }
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            continue;
+        }
+        if (start == npos) {
+            start = i;
+        }
+        if (c == '"') {
+            i = skipString(i);
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+    }
+    if (arrayMode) {
+        throw std::runtime_error("Expected ',' or ']' in array");
+    }
+    if (start != npos) {
+        ranges.emplace_back(start, input.size());
+    }
+    // A single record gains nothing from fan-out
+    if (ranges.size() < 2) {
+        ranges.clear();
+    }
+    return ranges;
+}
+
+// ---- Shared task pool ----
+// One process-wide set of worker threads shared by parseParallel and
+// the parallel tree algorithms below, so concurrent callers do not
+// multiply thread counts. Batches claim work from a shared counter
+// (the same balancing scheme parseParallel used per-call), which keeps
+// uneven task sizes from idling workers.
+class TaskPool {
+public:
+    explicit TaskPool(size_t threadCount = std::thread::hardware_concurrency()) {
+        if (threadCount == 0) {
+            threadCount = 1;
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // Process-wide pool, created on first use
+    static TaskPool& shared() {
+        static TaskPool pool;
+        return pool;
+    }
+
+    // Run fn(0) .. fn(count-1) across the pool and block until all of
+    // them finish; the calling thread claims work too, so the pool is
+    // useful even on one hardware thread. A task may itself call
+    // forEach: a thread waiting on its batch drains the pool queue
+    // instead of blocking, so nested sub-runners always find a thread.
+    // The first exception raised by any task is rethrown once the batch
+    // drains. maxParallelism caps the fan-out (0 means "whatever the
+    // pool has").
+    void forEach(size_t count, const std::function<void(size_t)>& fn, size_t maxParallelism = 0) {
+        if (count == 0) {
+            return;
+        }
+        size_t fanOut = maxParallelism ? maxParallelism : workers.size() + 1;
+        fanOut = std::min(fanOut, count);
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> exited{0};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        // Each runner claims indices until none remain; the batch is
+        // complete only when every runner has exited, so the captured
+        // locals stay alive for any runner still queued.
+        auto runner = [&]() {
+            for (size_t idx = next.fetch_add(1); idx < count; idx = next.fetch_add(1)) {
+                try {
+                    fn(idx);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (exited.fetch_add(1) + 1 == fanOut) {
+                std::lock_guard<std::mutex> lock(mutex);
+                wake.notify_all();
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 1; i < fanOut; ++i) {
+                tasks.emplace_back(runner);
+            }
+        }
+        wake.notify_all();
+        runner();
+
+        // Help while the batch drains: if every thread in a nested call
+        // chain merely blocked here, the queued sub-runners would have
+        // no thread left to run on and the pool would deadlock.
+        std::unique_lock<std::mutex> lock(mutex);
+        while (exited.load() != fanOut) {
+            if (!tasks.empty()) {
+                std::function<void()> task = std::move(tasks.front());
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+                continue;
+            }
+            wake.wait(lock, [&, this] { return exited.load() == fanOut || !tasks.empty(); });
+        }
+        lock.unlock();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void workerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+// Parse a large top-level array (or newline-delimited records, returned
+// as one array) across the shared task pool. Elements are claimed from
+// a shared counter so uneven element sizes still balance; nThreads caps
+// the fan-out. Worker threads parse with the default allocator; in
+// zero-copy mode their strings still alias the shared input buffer.
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseParallel(size_t nThreads) {
+    std::vector<std::pair<size_t, size_t>> elements = splitTopLevel();
+    if (elements.empty()) {
+        return parse();
+    }
+    if (nThreads == 0) {
+        nThreads = 1;
+    }
+
+    std::vector<JSONValue> slots(elements.size());
+    TaskPool::shared().forEach(elements.size(), [&](size_t idx) {
+        auto [from, to] = elements[idx];
+        std::string_view chunk = input.substr(from, to - from);
+        if (borrowed) {
+            BasicJSONParser sub(chunk);
+            slots[idx] = sub.parse();
+        } else {
+            BasicJSONParser sub{std::string(chunk)};
+            slots[idx] = sub.parse();
+        }
+    }, nThreads);
+
+    JSONValue array(JSONValue::Type::ARRAY, memory);
+    array.arrayValue().reserve(slots.size());
+    for (auto& slot : slots) {
+        array.arrayValue().push_back(std::move(slot));
+    }
+    position = input.size();
+    return array;
+}
+
+// ---- Streaming (SAX-style) parser ----
+// Pushes one event per token to a handler and never builds a tree, so
+// memory stays constant no matter how large the document is. Override
+// only the callbacks you care about.
+class JSONEventHandler {
+public:
+    virtual ~JSONEventHandler() = default;
+    virtual void onStartObject() {}
+    virtual void onEndObject() {}
+    virtual void onStartArray() {}
+    virtual void onEndArray() {}
+    virtual void onKey(std::string_view) {}
+    virtual void onString(std::string_view) {}
+    virtual void onNumber(double) {}
+    virtual void onBoolean(bool) {}
+    virtual void onNull() {}
+};
+
+class JSONStreamParser {
+public:
+    explicit JSONStreamParser(std::string_view json) : input(json), position(0) {}
+
+    void parse(JSONEventHandler& handler) {
+        skipWhitespace();
+        parseValue(handler);
+        skipWhitespace();
+        if (position != input.size()) {
+            throw std::runtime_error("Unexpected characters at end of JSON input");
+        }
+    }
+
+private:
+    std::string_view input;
+    size_t position;
+
+    char peek() {
+        return position < input.size() ? input[position] : '\0';
+    }
+
+    void skipWhitespace() {
+        position = scanWhitespaceImpl(input.data(), input.size(), position);
+    }
+
+    void parseValue(JSONEventHandler& handler) {
+        skipWhitespace();
+        char current = peek();
+        if (current == '{') { parseObject(handler); return; }
+        if (current == '[') { parseArray(handler); return; }
+        if (current == '"') {
+            StringToken token = lexString(input, position);
+            handler.onString(token.text);
+            return;
+        }
+        if (std::isdigit(current) || current == '-') {
+            handler.onNumber(lexNumber(input, position));
+            return;
+        }
+        if (input.compare(position, 4, "true") == 0) { position += 4; handler.onBoolean(true); return; }
+        if (input.compare(position, 5, "false") == 0) { position += 5; handler.onBoolean(false); return; }
+        if (input.compare(position, 4, "null") == 0) { position += 4; handler.onNull(); return; }
+
+        throw std::runtime_error("Invalid JSON value");
+    }
+
+    void parseObject(JSONEventHandler& handler) {
+        consumeChar(input, position); // Consume '{'
+        handler.onStartObject();
+        skipWhitespace();
+
+        while (peek() != '}') {
+            skipWhitespace();
+            StringToken key = lexString(input, position);
+            handler.onKey(key.text);
+            skipWhitespace();
+            if (consumeChar(input, position) != ':') {
+                throw std::runtime_error("Expected ':' in object");
+            }
+            parseValue(handler);
+            skipWhitespace();
+
+            if (peek() == ',') {
+                consumeChar(input, position); // Consume ','
+            } else if (peek() == '}') {
+                break;
+            } else {
+                throw std::runtime_error("Expected ',' or '}' in object");
+            }
+        }
+        consumeChar(input, position); // Consume '}'
+        handler.onEndObject();
+    }
+
+    void parseArray(JSONEventHandler& handler) {
+        consumeChar(input, position); // Consume '['
+        handler.onStartArray();
+        skipWhitespace();
+
+        while (peek() != ']') {
+            parseValue(handler);
+            skipWhitespace();
+
+            if (peek() == ',') {
+                consumeChar(input, position); // Consume ','
+            } else if (peek() == ']') {
+                break;
+            } else {
+                throw std::runtime_error("Expected ',' or ']' in array");
+            }
+        }
+        consumeChar(input, position); // Consume ']'
+        handler.onEndArray();
+    }
+};
+
+// Printed with one explicit frame per open container, like the writer's
+// iterative core, so deep documents spend heap instead of thread stack
+inline void printJSON(const JSONValue& value, int indent = 0) {
+    struct Frame {
+        const JSONValue* container;
+        int indent;
+        size_t next = 0;
+    };
+    std::vector<Frame> stack;
+    const JSONValue* current = &value;
+    int currentIndent = indent;
+
+    while (true) {
+        switch (current->type()) {
+            case JSONValue::Type::OBJECT:
+                std::cout << "{\n";
+                stack.push_back(Frame{current, currentIndent});
+                break;
+            case JSONValue::Type::ARRAY:
+                std::cout << "[\n";
+                stack.push_back(Frame{current, currentIndent});
+                break;
+            case JSONValue::Type::STRING:
+                std::cout << "\"" << current->stringView() << "\"\n";
+                break;
+            case JSONValue::Type::NUMBER:
+                std::cout << current->numberValue() << "\n";
+                break;
+            case JSONValue::Type::BOOLEAN:
+                std::cout << (current->boolValue() ? "true" : "false") << "\n";
+                break;
+            case JSONValue::Type::NULLVALUE:
+                std::cout << "null\n";
+                break;
+        }
+        // Walk up to the next pending child, closing what finished
+        bool descending = false;
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            std::string indentation(top.indent, ' ');
+            if (top.container->type() == JSONValue::Type::OBJECT) {
+                const auto& object = top.container->objectValue();
+                if (top.next < object.size()) {
+                    const auto& [key, val] = *(object.begin() + top.next);
+                    std::cout << indentation << "  \"" << key << "\": ";
+                    current = &val;
+                    currentIndent = top.indent + 2;
+                    top.next++;
+                    descending = true;
+                    break;
+                }
+                std::cout << indentation << "}\n";
+            } else {
+                const auto& array = top.container->arrayValue();
+                if (top.next < array.size()) {
+                    current = &array[top.next];
+                    currentIndent = top.indent + 2;
+                    top.next++;
+                    descending = true;
+                    break;
+                }
+                std::cout << indentation << "]\n";
+            }
+            stack.pop_back();
+        }
+        if (!descending) {
+            return;
+        }
+    }
+}
+
+// Outcome of the DOM-free validation scan. position is the byte offset
+// of the first error and line its 1-based line number; both are only
+// meaningful when valid is false. error points at a static description,
+// so reporting a failure allocates nothing either.
+struct ValidationResult {
+    bool valid;
+    size_t position = 0;
+    size_t line = 1;
+    const char* error = nullptr;
+};
+
+// Validate without building a DOM: walk the token grammar with the same
+// vectorized scans the parser uses, tracking only the open-container
+// kinds (one bit per level) instead of constructing objects, arrays and
+// strings that would be destroyed immediately. Accepts exactly what the
+// parse engines accept, including their tolerance of a trailing comma
+// in arrays but not in objects.
+inline ValidationResult scanJSON(std::string_view json) {
+    enum class Step { Value, KeyOrClose, Colon, CommaOrClose, Done };
+    constexpr size_t kMaxScanDepth = 1024; // matches the parser's default
+    uint64_t kinds[kMaxScanDepth / 64] = {};  // bit set: object level
+    uint64_t firsts[kMaxScanDepth / 64] = {}; // bit set: no member seen yet
+    size_t depth = 0;
+    Step step = Step::Value;
+    size_t pos = 0;
+
+    auto fail = [&json](size_t at, const char* message) {
+        ValidationResult result{false, at, 1, message};
+        for (size_t i = 0; i < at && i < json.size(); ++i) {
+            if (json[i] == '\n') result.line++;
+        }
+        return result;
+    };
+    auto levelBit = [](uint64_t* bits, size_t level) {
+        return (bits[level / 64] >> (level % 64)) & 1;
+    };
+    auto setLevelBit = [](uint64_t* bits, size_t level, bool on) {
+        if (on) bits[level / 64] |= uint64_t(1) << (level % 64);
+        else bits[level / 64] &= ~(uint64_t(1) << (level % 64));
+    };
+
+    // Validate one string token in place; escapes are checked but never
+    // decoded. Returns a static error message, or nullptr on success.
+    auto scanString = [&json](size_t& at) -> const char* {
+        at++; // Consume '"'
+        while (true) {
+            at = scanStringImpl(json.data(), json.size(), at);
+            if (at >= json.size()) {
+                return "Unterminated string";
+            }
+            if (json[at] == '"') {
+                at++;
+                return nullptr;
+            }
+            at++; // the backslash
+            if (at >= json.size()) {
+                return "Unterminated string";
+            }
+            char escaped = json[at++];
+            if (escaped == 'u') {
+                int unit = lexHex4(json, at);
+                if (unit < 0) {
+                    return "Invalid Unicode escape sequence";
+                }
+                if (unit >= 0xD800 && unit <= 0xDBFF) {
+                    if (at + 1 >= json.size() || json[at] != '\\' || json[at + 1] != 'u') {
+                        return "Unpaired surrogate in Unicode escape";
+                    }
+                    at += 2;
+                    int low = lexHex4(json, at);
+                    if (low < 0) {
+                        return "Invalid Unicode escape sequence";
+                    }
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return "Unpaired surrogate in Unicode escape";
+                    }
+                } else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+                    return "Unpaired surrogate in Unicode escape";
+                }
+            } else if (escaped != '"' && escaped != '\\' && escaped != '/' &&
+                       escaped != 'b' && escaped != 'f' && escaped != 'n' &&
+                       escaped != 'r' && escaped != 't') {
+                return "Invalid escape character";
+            }
+        }
+    };
+
+    while (true) {
+        pos = scanWhitespaceImpl(json.data(), json.size(), pos);
+        if (pos >= json.size()) {
+            if (step == Step::Done) {
+                return ValidationResult{true};
+            }
+            return fail(pos, "Unexpected end of input");
+        }
+        char current = json[pos];
+
+        switch (step) {
+            case Step::Value: {
+                if (depth > 0 && !levelBit(kinds, depth - 1) && current == ']') {
+                    pos++;
+                    depth--;
+                    step = depth == 0 ? Step::Done : Step::CommaOrClose;
+                    if (depth > 0) setLevelBit(firsts, depth - 1, false);
+                    break;
+                }
+                if (current == '{' || current == '[') {
+                    if (depth >= kMaxScanDepth) {
+                        return fail(pos, "Maximum nesting depth exceeded");
+                    }
+                    pos++;
+                    setLevelBit(kinds, depth, current == '{');
+                    setLevelBit(firsts, depth, true);
+                    depth++;
+                    step = current == '{' ? Step::KeyOrClose : Step::Value;
+                    break;
+                }
+                if (current == '"') {
+                    size_t at = pos;
+                    if (const char* error = scanString(pos)) {
+                        return fail(at, error);
+                    }
+                } else if (std::isdigit(current) || current == '-') {
+                    std::string_view text = lexRawNumber(json, pos);
+                    double value = 0.0;
+                    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+                    if (ec != std::errc() || end != text.data() + text.size()) {
+                        return fail(pos - text.size(), "Invalid number");
+                    }
+                } else if (json.compare(pos, 4, "true") == 0) {
+                    pos += 4;
+                } else if (json.compare(pos, 5, "false") == 0) {
+                    pos += 5;
+                } else if (json.compare(pos, 4, "null") == 0) {
+                    pos += 4;
+                } else {
+                    return fail(pos, "Invalid JSON value");
+                }
+                if (depth == 0) {
+                    step = Step::Done;
+                } else {
+                    setLevelBit(firsts, depth - 1, false);
+                    step = Step::CommaOrClose;
+                }
+                break;
+            }
+            case Step::KeyOrClose: {
+                if (current == '}' && levelBit(firsts, depth - 1)) {
+                    pos++;
+                    depth--;
+                    step = depth == 0 ? Step::Done : Step::CommaOrClose;
+                    if (depth > 0) setLevelBit(firsts, depth - 1, false);
+                    break;
+                }
+                if (current != '"') {
+                    return fail(pos, "Expected string key in object");
+                }
+                size_t at = pos;
+                if (const char* error = scanString(pos)) {
+                    return fail(at, error);
+                }
+                step = Step::Colon;
+                break;
+            }
+            case Step::Colon: {
+                if (current != ':') {
+                    return fail(pos, "Expected ':' in object");
+                }
+                pos++;
+                step = Step::Value;
+                break;
+            }
+            case Step::CommaOrClose: {
+                bool isObject = levelBit(kinds, depth - 1);
+                if (current == ',') {
+                    pos++;
+                    step = isObject ? Step::KeyOrClose : Step::Value;
+                    break;
+                }
+                if (isObject ? current == '}' : current == ']') {
+                    pos++;
+                    depth--;
+                    step = depth == 0 ? Step::Done : Step::CommaOrClose;
+                    if (depth > 0) setLevelBit(firsts, depth - 1, false);
+                    break;
+                }
+                return fail(pos, isObject ? "Expected ',' or '}' in object"
+                                          : "Expected ',' or ']' in array");
+            }
+            case Step::Done:
+                return fail(pos, "Unexpected characters at end of JSON input");
+        }
+    }
+}
+
+inline bool validateJSON(const std::string& json) {
+    ValidationResult result = scanJSON(json);
+    if (!result.valid) {
+        std::cerr << "Validation Error: " << result.error
+                  << " at line " << result.line
+                  << ", position " << result.position << std::endl;
+    }
+    return result.valid;
+}
+
+// Destination for serialized output. JSONWriter hands over large
+// contiguous chunks, so implementations only need a bulk write.
+class JSONSink {
+public:
+    virtual ~JSONSink() = default;
+    virtual void write(const char* data, size_t size) = 0;
+    virtual void flush() {}
+};
+
+// Buffered file sink: output accumulates in a large internal buffer and
+// leaves through plain write() calls, so serializing a document far
+// bigger than memory runs at disk speed with a fixed footprint instead
+// of holding the whole output as one string.
+class FileSink : public JSONSink {
+public:
+    explicit FileSink(const std::string& filename, size_t bufferSize = size_t(4) << 20)
+        : capacity(bufferSize) {
+        buffer.reserve(capacity);
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_WRITE, 0, nullptr,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Unable to open file: " + filename);
+        }
+#else
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open file: " + filename);
+        }
+#endif
+    }
+
+    ~FileSink() override {
+        try {
+            flush();
+        } catch (...) {
+            // destructor must not throw; an explicit flush() reports errors
+        }
+#ifdef _WIN32
+        CloseHandle(file);
+#else
+        ::close(fd);
+#endif
+    }
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    void write(const char* data, size_t size) override {
+        if (buffer.size() + size > capacity) {
+            flush();
+        }
+        if (size >= capacity) {
+            writeRaw(data, size); // oversized chunk: straight through
+        } else {
+            buffer.append(data, size);
+        }
+    }
+
+    void flush() override {
+        if (!buffer.empty()) {
+            writeRaw(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+private:
+    void writeRaw(const char* data, size_t size) {
+#ifdef _WIN32
+        while (size > 0) {
+            DWORD written = 0;
+            if (!WriteFile(file, data, static_cast<DWORD>(size), &written, nullptr)) {
+                throw std::runtime_error("Write failed");
+            }
+            data += written;
+            size -= written;
+        }
+#else
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("Write failed");
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+#endif
+    }
+
+    std::string buffer;
+    size_t capacity;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+};
+
+// ---- Writer-based serializer ----
+// Serialization used to be built from nested std::string concatenations,
+// copying every subtree's text repeatedly up the recursion. JSONWriter
+// appends into a single caller-owned buffer, reserved up front from a
+// cheap size estimate, so a document is written with one pass and no
+// temporaries. Writing to a JSONSink instead stages output in a fixed
+// window and hands full windows to the sink, so peak memory no longer
+// scales with the document.
+class JSONWriter {
+public:
+    explicit JSONWriter(std::string& out) : buffer(out) {}
+    explicit JSONWriter(JSONSink& out) : buffer(scratch), sink(&out) {}
+
+    void write(const JSONValue& value) {
+        if (sink) {
+            buffer.reserve(kFlushThreshold);
+        } else {
+            buffer.reserve(buffer.size() + estimate(value));
+        }
+        writeValue(value);
+        if (sink) {
+            sink->write(buffer.data(), buffer.size());
+            buffer.clear();
+            sink->flush();
+        }
+    }
+
+    // Rough byte count of the serialized form, used to size the buffer.
+    // Walked with an explicit worklist for the same reason writeValue
+    // uses frames: sizing must survive any document the parser's depth
+    // limit was raised to accept.
+    static size_t estimate(const JSONValue& value) {
+        size_t total = 0;
+        std::vector<const JSONValue*> pending{&value};
+        while (!pending.empty()) {
+            const JSONValue* current = pending.back();
+            pending.pop_back();
+            switch (current->type()) {
+                case JSONValue::Type::OBJECT:
+                    total += 2;
+                    for (const auto& [key, val] : current->objectValue()) {
+                        total += key.size() + 4;
+                        pending.push_back(&val);
+                    }
+                    break;
+                case JSONValue::Type::ARRAY:
+                    total += 2 + current->arrayValue().size();
+                    for (const auto& val : current->arrayValue()) {
+                        pending.push_back(&val);
+                    }
+                    break;
+                case JSONValue::Type::STRING:
+                    total += current->stringView().size() + 2;
+                    break;
+                case JSONValue::Type::NUMBER:
+                    total += 24;
+                    break;
+                case JSONValue::Type::BOOLEAN:
+                    total += 5;
+                    break;
+                case JSONValue::Type::NULLVALUE:
+                    total += 4;
+                    break;
+            }
+        }
+        return total;
+    }
+
+private:
+    std::string scratch;     // staging window in sink mode
+    std::string& buffer;
+    JSONSink* sink = nullptr;
+    static constexpr size_t kFlushThreshold = size_t(1) << 20;
+
+    // In sink mode, hand off the staging window once it fills; appends
+    // between checks are single tokens, so the overshoot stays small
+    void maybeFlush() {
+        if (sink && buffer.size() >= kFlushThreshold) {
+            sink->write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    // Iterative core: one explicit frame per open container, so writing
+    // is immune to deep nesting regardless of document shape
+    void writeValue(const JSONValue& root) {
+        struct Frame {
+            const JSONValue* container;
+            size_t next = 0;
+        };
+        std::vector<Frame> stack;
+        const JSONValue* current = &root;
+
+        while (true) {
+            switch (current->type()) {
+                case JSONValue::Type::OBJECT:
+                    buffer += '{';
+                    stack.push_back({current});
+                    break;
+                case JSONValue::Type::ARRAY:
+                    buffer += '[';
+                    stack.push_back({current});
+                    break;
+                case JSONValue::Type::STRING:
+                    buffer += '"';
+                    appendEscaped(buffer, current->stringView());
+                    buffer += '"';
+                    break;
+                case JSONValue::Type::NUMBER:
+                    appendNumber(buffer, current->numberValue());
+                    break;
+                case JSONValue::Type::BOOLEAN:
+                    buffer += current->boolValue() ? "true" : "false";
+                    break;
+                case JSONValue::Type::NULLVALUE:
+                    buffer += "null";
+                    break;
+            }
+            maybeFlush();
+            // Walk up to the next pending sibling, closing what finished
+            bool descending = false;
+            while (!stack.empty()) {
+                Frame& top = stack.back();
+                if (top.container->type() == JSONValue::Type::OBJECT) {
+                    const auto& object = top.container->objectValue();
+                    if (top.next < object.size()) {
+                        const auto& [key, val] = *(object.begin() + top.next);
+                        if (top.next > 0) buffer += ',';
+                        buffer += '"';
+                        appendEscaped(buffer, key);
+                        buffer += "\":";
+                        current = &val;
+                        top.next++;
+                        descending = true;
+                        break;
+                    }
+                    buffer += '}';
+                } else {
+                    const auto& array = top.container->arrayValue();
+                    if (top.next < array.size()) {
+                        if (top.next > 0) buffer += ',';
+                        current = &array[top.next];
+                        top.next++;
+                        descending = true;
+                        break;
+                    }
+                    buffer += ']';
+                }
+                stack.pop_back();
+            }
+            if (!descending) {
+                return;
+            }
+        }
+    }
+
+    // Reference path: the original recursive writer, kept for comparison
+    void writeValueRecursive(const JSONValue& value) {
+        switch (value.type()) {
+            case JSONValue::Type::OBJECT: {
+                buffer += '{';
+                bool first = true;
+                for (const auto& [key, val] : value.objectValue()) {
+                    if (!first) buffer += ',';
+                    first = false;
+                    buffer += '"';
+                    appendEscaped(buffer, key);
+                    buffer += "\":";
+                    writeValue(val);
+                }
+                buffer += '}';
+                break;
+            }
+            case JSONValue::Type::ARRAY: {
+                buffer += '[';
+                bool first = true;
+                for (const auto& val : value.arrayValue()) {
+                    if (!first) buffer += ',';
+                    first = false;
+                    writeValue(val);
+                }
+                buffer += ']';
+                break;
+            }
+            case JSONValue::Type::STRING:
+                buffer += '"';
+                appendEscaped(buffer, value.stringView());
+                buffer += '"';
+                break;
+            case JSONValue::Type::NUMBER:
+                appendNumber(buffer, value.numberValue());
+                break;
+            case JSONValue::Type::BOOLEAN:
+                buffer += value.boolValue() ? "true" : "false";
+                break;
+            case JSONValue::Type::NULLVALUE:
+                buffer += "null";
+                break;
+        }
+        maybeFlush();
+    }
+};
+
+inline std::string serializeJSON(const JSONValue& value) {
+    std::string result;
+    JSONWriter writer(result);
+    writer.write(value);
+    return result;
+}
+
+// Serialize straight to a file through a buffered sink; peak memory is
+// the staging window plus the sink buffer, not the output size
+inline void serializeJSONToFile(const JSONValue& value, const std::string& filename) {
+    FileSink sink(filename);
+    JSONWriter writer(sink);
+    writer.write(value);
+}
+
+// Memory-mapped read-only file: the OS page cache is the only copy of
+// the data, so multi-gigabyte inputs open in milliseconds instead of
+// being slurped byte by byte into a std::string. The view() pairs with
+// the zero-copy JSONParser(std::string_view) mode; keep the MappedFile
+// alive as long as any borrowed strings from the parse are in use.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open file");
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            throw std::runtime_error("Failed to stat file");
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping) {
+                CloseHandle(file);
+                throw std::runtime_error("Failed to map file");
+            }
+            start = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!start) {
+                CloseHandle(mapping);
+                CloseHandle(file);
+                throw std::runtime_error("Failed to map file");
+            }
+        }
+#else
+        fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Failed to open file");
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Failed to stat file");
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Failed to map file");
+            }
+            start = static_cast<const char*>(mapped);
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (start) UnmapViewOfFile(start);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (start) munmap(const_cast<char*>(start), length);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const { return {start, length}; }
+    size_t size() const { return length; }
+
+private:
+    const char* start = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+inline std::string readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) throw std::runtime_error("Failed to open file");
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+inline void writeFile(const std::string& filename, const std::string& data) {
+    std::ofstream file(filename);
+    if (!file) throw std::runtime_error("Failed to write to file");
+    file << data;
+}
+
+// ---- Binary snapshots ----
+// Re-parsing the same large reference documents at every service start
+// burns seconds of CPU on text the process has seen a thousand times.
+// The binary form is one tagged, length-prefixed node per value behind
+// a magic/version header, written and read in a single pass in host
+// byte order, so load time is bounded by disk bandwidth.
+
+constexpr char kBinaryMagic[4] = {'J', 'S', 'N', 'B'};
+constexpr uint32_t kBinaryVersion = 1;
+
+inline void appendRaw(std::string& out, const void* bytes, size_t size) {
+    out.append(static_cast<const char*>(bytes), size);
+}
+
+inline void appendU64(std::string& out, uint64_t value) {
+    appendRaw(out, &value, sizeof(value));
+}
+
+inline void readRaw(std::string_view data, size_t& offset, void* bytes, size_t size) {
+    if (offset + size > data.size()) {
+        throw std::runtime_error("Corrupt binary snapshot");
+    }
+    std::memcpy(bytes, data.data() + offset, size);
+    offset += size;
+}
+
+inline uint64_t readU64(std::string_view data, size_t& offset) {
+    uint64_t value = 0;
+    readRaw(data, offset, &value, sizeof(value));
+    return value;
+}
+
+// Encoded with one explicit frame per open container, like the writer,
+// so snapshotting a document as deep as the parser's raised depth limit
+// allows cannot overflow the thread stack
+inline void encodeBinary(const JSONValue& value, std::string& out) {
+    struct Frame {
+        const JSONValue* container;
+        size_t next = 0;
+    };
+    std::vector<Frame> stack;
+    const JSONValue* current = &value;
+
+    while (true) {
+        out += static_cast<char>(static_cast<uint8_t>(current->type()));
+        switch (current->type()) {
+            case JSONValue::Type::OBJECT:
+                appendU64(out, current->objectValue().size());
+                stack.push_back({current});
+                break;
+            case JSONValue::Type::ARRAY:
+                appendU64(out, current->arrayValue().size());
+                stack.push_back({current});
+                break;
+            case JSONValue::Type::STRING: {
+                std::string_view text = current->stringView();
+                appendU64(out, text.size());
+                appendRaw(out, text.data(), text.size());
+                break;
+            }
+            case JSONValue::Type::NUMBER: {
+                double number = current->numberValue();
+                appendRaw(out, &number, sizeof(number));
+                break;
+            }
+            case JSONValue::Type::BOOLEAN:
+                out += static_cast<char>(current->boolValue() ? 1 : 0);
+                break;
+            case JSONValue::Type::NULLVALUE:
+                break;
+        }
+        // Walk up to the next pending child, keys emitted on the way down
+        bool descending = false;
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (top.container->type() == JSONValue::Type::OBJECT) {
+                const auto& object = top.container->objectValue();
+                if (top.next < object.size()) {
+                    const auto& [key, val] = *(object.begin() + top.next);
+                    appendU64(out, key.size());
+                    out += key;
+                    current = &val;
+                    top.next++;
+                    descending = true;
+                    break;
+                }
+            } else {
+                const auto& array = top.container->arrayValue();
+                if (top.next < array.size()) {
+                    current = &array[top.next];
+                    top.next++;
+                    descending = true;
+                    break;
+                }
+            }
+            stack.pop_back();
+        }
+        if (!descending) {
+            return;
+        }
+    }
+}
+
+// Decoded with the parse engines' frame-stack pattern: a snapshot of
+// any depth (saved legitimately or crafted) either loads or throws
+// "Corrupt binary snapshot" -- it never recurses per node
+inline JSONValue decodeBinary(std::string_view data, size_t& offset) {
+    struct Frame {
+        JSONValue container;
+        uint64_t remaining;
+        bool isObject;
+        std::string pendingKey;
+    };
+    std::vector<Frame> stack;
+    JSONValue completed;
+    bool haveValue = false;
+
+    while (true) {
+        if (haveValue) {
+            if (stack.empty()) {
+                return completed;
+            }
+            Frame& top = stack.back();
+            if (top.isObject) {
+                top.container.objectValue()[std::move(top.pendingKey)] = std::move(completed);
+            } else {
+                top.container.arrayValue().push_back(std::move(completed));
+            }
+            top.remaining--;
+            haveValue = false;
+            continue;
+        }
+        if (!stack.empty() && stack.back().remaining == 0) {
+            completed = std::move(stack.back().container);
+            stack.pop_back();
+            haveValue = true;
+            continue;
+        }
+        if (!stack.empty() && stack.back().isObject) {
+            uint64_t keySize = readU64(data, offset);
+            if (keySize > data.size() - offset) {
+                throw std::runtime_error("Corrupt binary snapshot");
+            }
+            stack.back().pendingKey = std::string(data.substr(offset, keySize));
+            offset += keySize;
+        }
+        uint8_t tag = 0;
+        readRaw(data, offset, &tag, 1);
+        switch (static_cast<JSONValue::Type>(tag)) {
+            case JSONValue::Type::OBJECT: {
+                uint64_t count = readU64(data, offset);
+                stack.push_back(Frame{JSONValue(JSONValue::Type::OBJECT), count, true, {}});
+                break;
+            }
+            case JSONValue::Type::ARRAY: {
+                uint64_t count = readU64(data, offset);
+                Frame frame{JSONValue(JSONValue::Type::ARRAY), count, false, {}};
+                // a count larger than the bytes left cannot be honest
+                if (count > data.size() - offset) {
+                    throw std::runtime_error("Corrupt binary snapshot");
+                }
+                frame.container.arrayValue().reserve(count);
+                stack.push_back(std::move(frame));
+                break;
+            }
+            case JSONValue::Type::STRING: {
+                uint64_t size = readU64(data, offset);
+                if (size > data.size() - offset) {
+                    throw std::runtime_error("Corrupt binary snapshot");
+                }
+                completed = JSONValue{std::string(data.substr(offset, size))};
+                offset += size;
+                haveValue = true;
+                break;
+            }
+            case JSONValue::Type::NUMBER: {
+                double number = 0.0;
+                readRaw(data, offset, &number, sizeof(number));
+                completed = JSONValue(number);
+                haveValue = true;
+                break;
+            }
+            case JSONValue::Type::BOOLEAN: {
+                uint8_t flag = 0;
+                readRaw(data, offset, &flag, 1);
+                completed = JSONValue(flag != 0);
+                haveValue = true;
+                break;
+            }
+            case JSONValue::Type::NULLVALUE:
+                completed = JSONValue();
+                haveValue = true;
+                break;
+            default:
+                throw std::runtime_error("Corrupt binary snapshot");
+        }
+    }
+}
+
+inline void saveBinary(const std::string& filename, const JSONValue& value) {
+    std::string out;
+    appendRaw(out, kBinaryMagic, sizeof(kBinaryMagic));
+    appendRaw(out, &kBinaryVersion, sizeof(kBinaryVersion));
+    encodeBinary(value, out);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to write to file");
+    file.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+inline JSONValue loadBinary(const std::string& filename) {
+    MappedFile file(filename);
+    std::string_view data = file.view();
+    size_t offset = 0;
+    char magic[4];
+    readRaw(data, offset, magic, sizeof(magic));
+    if (std::memcmp(magic, kBinaryMagic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a binary JSON snapshot");
+    }
+    uint32_t version = 0;
+    readRaw(data, offset, &version, sizeof(version));
+    if (version != kBinaryVersion) {
+        throw std::runtime_error("Unsupported binary snapshot version " + std::to_string(version));
+    }
+    JSONValue value = decodeBinary(data, offset);
+    if (offset != data.size()) {
+        throw std::runtime_error("Trailing bytes in binary snapshot");
+    }
+    return value;
+}
+
+inline char consume(std::string &input, size_t &position) {
+    if (position >= input.size()) {
+        throw std::runtime_error("Unexpected end of input at position " + std::to_string(position));
+    }
+    return input[position++];
+}
+
+template <class Options>
+JSONValue BasicJSONParser<Options>::parseString() {
+    RawStringToken token = lexRawString(input, position);
+    JSON_STATS(parseStats.strings++);
+    if (checkUtf8 && !validateUtf8(token.raw)) {
+        throw std::runtime_error("Invalid UTF-8 in string");
+    }
+    if (!token.escaped) {
+        if constexpr (Options::borrowStrings) {
+            if (borrowed) {
+                JSON_STATS(parseStats.stringBytesViewed += token.raw.size());
+                return JSONValue(token.raw); // view into the caller's buffer
+            }
+        }
+        JSON_STATS(parseStats.stringBytesCopied += token.raw.size());
+        return JSONValue(std::string(token.raw));
+    }
+    if (lazy) {
+        JSON_STATS(parseStats.stringBytesViewed += token.raw.size());
+        return JSONValue(JSONValue::RawString{token.raw});
+    }
+    JSON_STATS(parseStats.stringBytesCopied += token.raw.size());
+    return JSONValue(decodeStringEscapes(token.raw));
+}
+
+inline void updateJSON(JSONValue& root, const std::string& key, const JSONValue& newValue) {
+    if (root.type() == JSONValue::Type::OBJECT && root.objectValue().count(key)) {
+        root.objectValue()[key] = newValue;
+    } else {
+        throw std::runtime_error("Key not found or not an object");
+    }
+}
+
+// Rvalue overload: the replacement subtree moves in instead of being
+// deep-copied member by member
+inline void updateJSON(JSONValue& root, const std::string& key, JSONValue&& newValue) {
+    if (root.type() == JSONValue::Type::OBJECT && root.objectValue().count(key)) {
+        root.objectValue()[key] = std::move(newValue);
+    } else {
+        throw std::runtime_error("Key not found or not an object");
+    }
+}
+
+// Compiled dot-path: the path text is tokenized once, then evaluated
+// any number of times by walking references -- no stringstream, no
+// per-call allocation and, unlike the old queryJSON loop, no deep copy
+// of every intermediate subtree.
+class JSONPath {
+public:
+    static JSONPath compile(const std::string& path) {
+        JSONPath compiled;
+        size_t start = 0;
+        while (start <= path.size()) {
+            size_t dot = path.find('.', start);
+            if (dot == std::string::npos) {
+                dot = path.size();
+            }
+            Segment segment;
+            segment.key = path.substr(start, dot - start);
+            segment.isIndex = !segment.key.empty() &&
+                              segment.key.find_first_not_of("0123456789") == std::string::npos;
+            if (segment.isIndex) {
+                segment.index = std::stoul(segment.key);
+            }
+            compiled.segments.push_back(std::move(segment));
+            start = dot + 1;
+        }
+        return compiled;
+    }
+
+    // Returns nullptr when the path does not resolve
+    const JSONValue* evaluate(const JSONValue& root) const {
+        const JSONValue* current = &root;
+        for (const Segment& segment : segments) {
+            if (current->type() == JSONValue::Type::OBJECT) {
+                auto it = current->objectValue().find(segment.key);
+                if (it == current->objectValue().end()) {
+                    return nullptr;
+                }
+                current = &it->second;
+            } else if (current->type() == JSONValue::Type::ARRAY && segment.isIndex) {
+                if (segment.index >= current->arrayValue().size()) {
+                    return nullptr;
+                }
+                current = &current->arrayValue()[segment.index];
+            } else {
+                return nullptr;
+            }
+        }
+        return current;
+    }
+
+private:
+    struct Segment {
+        std::string key;
+        size_t index = 0;
+        bool isIndex = false;
+    };
+
+    std::vector<Segment> segments;
+};
+
+inline JSONValue queryJSON(const JSONValue& root, const std::string& path) {
+    const JSONValue* found = JSONPath::compile(path).evaluate(root);
+    if (!found) {
+        throw std::runtime_error("Invalid path: " + path);
+    }
+    return *found; // one copy at the very end, none along the way
+}
+
+inline void benchmark(const std::string& json) {
+    auto start = std::chrono::high_resolution_clock::now();
+    JSONParser parser(json);
+    parser.parse();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> duration = end - start;
+    std::cout << "Parsing time: " << duration.count() << " seconds\n";
+}
+
+inline void testJSONParser() {
+    std::string json = R"({"name": "Elina", "age": 23, "skills": ["Coding", "Music"], "active": true})";
+    JSONParser parser(json);
+    JSONValue result = parser.parse();
+
+    assert(result.type() == JSONValue::Type::OBJECT);
+    assert(result.objectValue().count("name"));
+    assert(result.objectValue()["name"].stringValue() == "Elina");
+
+    std::cout << "All tests passed!" << std::endl;
+}
+
+inline void mergeJSON(JSONValue& target, const JSONValue& source) {
+    if (target.type() == JSONValue::Type::OBJECT && source.type() == JSONValue::Type::OBJECT) {
+        for (const auto& [key, val] : source.objectValue()) {
+            if (target.objectValue().count(key)) {
+                mergeJSON(target.objectValue()[key], val);
+            } else {
+                target.objectValue()[key] = val;
+            }
+        }
+    } else {
+        target = source;
+    }
+}
+
+inline void deleteKey(JSONValue& root, const std::string& key) {
+    if (root.type() == JSONValue::Type::OBJECT) {
+        root.objectValue().erase(key);
+    } else {
+        throw std::runtime_error("Cannot delete key from a non-object JSON value");
+    }
+}
+
+// Append one element to an array by move; returns the stored element
+inline JSONValue& emplaceBack(JSONValue& root, JSONValue&& element) {
+    if (root.type() != JSONValue::Type::ARRAY) {
+        throw std::runtime_error("emplaceBack: JSON value is not an array");
+    }
+    root.arrayValue().push_back(std::move(element));
+    return root.arrayValue().back();
+}
+
+// vector-style splice: remove `removeCount` elements at `position` and
+// move `elements` in at that spot, all within the existing array
+inline void spliceArray(JSONValue& root, size_t position, size_t removeCount,
+                        std::vector<JSONValue>&& elements) {
+    if (root.type() != JSONValue::Type::ARRAY) {
+        throw std::runtime_error("spliceArray: JSON value is not an array");
+    }
+    auto& array = root.arrayValue();
+    if (position > array.size()) {
+        throw std::runtime_error("spliceArray: position out of range");
+    }
+    removeCount = std::min(removeCount, array.size() - position);
+    auto first = array.begin() + static_cast<ptrdiff_t>(position);
+    first = array.erase(first, first + static_cast<ptrdiff_t>(removeCount));
+    array.insert(first, std::make_move_iterator(elements.begin()),
+                 std::make_move_iterator(elements.end()));
+}
+
+// Take ownership of one member's subtree and remove the member --
+// map-node style, no copy of the extracted tree
+inline JSONValue extractKey(JSONValue& root, const std::string& key) {
+    if (root.type() != JSONValue::Type::OBJECT) {
+        throw std::runtime_error("extractKey: JSON value is not an object");
+    }
+    auto it = root.objectValue().find(key);
+    if (it == root.objectValue().end()) {
+        throw std::runtime_error("extractKey: key not found");
+    }
+    JSONValue extracted = std::move(it->second);
+    root.objectValue().erase(key);
+    return extracted;
+}
+
+// Insert or overwrite one member, moving the subtree in
+inline void adoptKey(JSONValue& root, const std::string& key, JSONValue&& subtree) {
+    if (root.type() != JSONValue::Type::OBJECT) {
+        throw std::runtime_error("adoptKey: JSON value is not an object");
+    }
+    root.objectValue()[key] = std::move(subtree);
+}
+
+inline bool validateSchema(const JSONValue& json, const JSONValue& schema) {
+    if (schema.type() != JSONValue::Type::OBJECT || json.type() != JSONValue::Type::OBJECT) {
+        throw std::runtime_error("Schema validation supports only JSON objects.");
+    }
+
+    for (const auto& [key, value] : schema.objectValue()) {
+        if (!json.objectValue().count(key)) {
+            std::cerr << "Validation Error: Missing key '" << key << "' in JSON.\n";
+            return false;
+        }
+        if (value.type() != json.objectValue().at(key).type()) {
+            std::cerr << "Validation Error: Type mismatch for key '" << key << "'.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compiled form of the schema objects validateSchema interprets. The
+// schema tree is flattened once into a rule vector — one entry per
+// required key with its expected type, nested object rules stored as an
+// index range into the same vector — so validating a document is a walk
+// over contiguous rules with string_view lookups and no per-document
+// allocation. Unlike validateSchema it checks nested object schemas
+// recursively, and it reports by return value only; keep the
+// interpreted version when cerr diagnostics are wanted.
+class CompiledSchema {
+public:
+    static CompiledSchema compile(const JSONValue& schema) {
+        if (schema.type() != JSONValue::Type::OBJECT) {
+            throw std::runtime_error("Schema validation supports only JSON objects.");
+        }
+        CompiledSchema compiled;
+        compiled.rootEnd = compileLevel(schema.objectValue(), compiled.rules);
+        return compiled;
+    }
+
+    bool validate(const JSONValue& json) const {
+        return check(json, 0, rootEnd);
+    }
+
+    // Validate raw text without building a DOM: one allocation-free
+    // well-formedness scan, then a token walk over the top level
+    // checking key presence and value types. Schemas with nested rules
+    // (or more keys than the seen-bitmap holds, or escaped keys in the
+    // input) fall back to a regular parse.
+    bool validate(std::string_view text) const {
+        if (!scanJSON(text).valid) {
+            return false;
+        }
+        bool nested = false;
+        for (const Rule& rule : rules) {
+            if (rule.childBegin != rule.childEnd) {
+                nested = true;
+                break;
+            }
+        }
+        if (nested || rules.size() > 64) {
+            JSONParser parser{text};
+            return validate(parser.parse());
+        }
+
+        size_t pos = scanWhitespaceImpl(text.data(), text.size(), 0);
+        if (pos >= text.size() || text[pos] != '{') {
+            return false;
+        }
+        pos++;
+        uint64_t seen = 0;
+        pos = scanWhitespaceImpl(text.data(), text.size(), pos);
+        if (pos < text.size() && text[pos] == '}') {
+            return rules.empty();
+        }
+        while (true) {
+            pos = scanWhitespaceImpl(text.data(), text.size(), pos);
+            RawStringToken key = lexRawString(text, pos);
+            if (key.escaped) {
+                JSONParser parser{text};
+                return validate(parser.parse());
+            }
+            pos = scanWhitespaceImpl(text.data(), text.size(), pos);
+            pos++; // ':' (well-formedness already established)
+            pos = scanWhitespaceImpl(text.data(), text.size(), pos);
+            JSONValue::Type type = tokenType(text[pos]);
+            for (size_t i = 0; i < rules.size(); ++i) {
+                if (rules[i].key == key.raw) {
+                    if (rules[i].type != type) {
+                        return false;
+                    }
+                    seen |= uint64_t(1) << i;
+                    break;
+                }
+            }
+            skipValueTokens(text, pos);
+            pos = scanWhitespaceImpl(text.data(), text.size(), pos);
+            if (text[pos] == ',') {
+                pos++;
+                continue;
+            }
+            break; // '}'
+        }
+        return rules.empty() || seen == (rules.size() == 64 ? ~uint64_t(0)
+                                                            : (uint64_t(1) << rules.size()) - 1);
+    }
+
+private:
+    struct Rule {
+        std::string key;
+        JSONValue::Type type;
+        uint32_t childBegin = 0; // nested rules; empty range for leaves
+        uint32_t childEnd = 0;
+    };
+
+    std::vector<Rule> rules;
+    uint32_t rootEnd = 0;
+
+    // Lay a whole level out contiguously, then recurse so each rule's
+    // children form one contiguous range further down the vector
+    static uint32_t compileLevel(const JSONObject& schema, std::vector<Rule>& rules) {
+        uint32_t begin = static_cast<uint32_t>(rules.size());
+        for (const auto& [key, val] : schema) {
+            rules.push_back(Rule{key, val.type()});
+        }
+        uint32_t end = static_cast<uint32_t>(rules.size());
+        uint32_t index = begin;
+        for (const auto& [key, val] : schema) {
+            if (val.type() == JSONValue::Type::OBJECT && !val.objectValue().empty()) {
+                uint32_t childBegin = static_cast<uint32_t>(rules.size());
+                uint32_t childEnd = compileLevel(val.objectValue(), rules);
+                rules[index].childBegin = childBegin;
+                rules[index].childEnd = childEnd;
+            }
+            index++;
+        }
+        return end;
+    }
+
+    bool check(const JSONValue& json, uint32_t begin, uint32_t end) const {
+        if (json.type() != JSONValue::Type::OBJECT) {
+            return false;
+        }
+        const auto& object = json.objectValue();
+        for (uint32_t i = begin; i < end; ++i) {
+            const Rule& rule = rules[i];
+            auto hit = object.find(rule.key);
+            if (hit == object.end() || hit->second.type() != rule.type) {
+                return false;
+            }
+            if (rule.childBegin != rule.childEnd && !check(hit->second, rule.childBegin, rule.childEnd)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static JSONValue::Type tokenType(char first) {
+        switch (first) {
+            case '{': return JSONValue::Type::OBJECT;
+            case '[': return JSONValue::Type::ARRAY;
+            case '"': return JSONValue::Type::STRING;
+            case 't': case 'f': return JSONValue::Type::BOOLEAN;
+            case 'n': return JSONValue::Type::NULLVALUE;
+            default: return JSONValue::Type::NUMBER;
+        }
+    }
+};
+
+// Printed with one explicit frame per open container, like the writer's
+// iterative core, so deep documents spend heap instead of thread stack
+inline void prettyPrintJSON(const JSONValue& value, int indent = 0) {
+    struct Frame {
+        const JSONValue* container;
+        int indent;
+        size_t next = 0;
+    };
+    std::vector<Frame> stack;
+    const JSONValue* current = &value;
+    int currentIndent = indent;
+
+    while (true) {
+        switch (current->type()) {
+            case JSONValue::Type::OBJECT:
+                std::cout << "{\n";
+                stack.push_back(Frame{current, currentIndent});
+                break;
+            case JSONValue::Type::ARRAY:
+                std::cout << "[\n";
+                stack.push_back(Frame{current, currentIndent});
+                break;
+            case JSONValue::Type::STRING:
+                std::cout << "\"" << current->stringView() << "\"\n";
+                break;
+            case JSONValue::Type::NUMBER:
+                std::cout << current->numberValue() << "\n";
+                break;
+            case JSONValue::Type::BOOLEAN:
+                std::cout << (current->boolValue() ? "true" : "false") << "\n";
+                break;
+            case JSONValue::Type::NULLVALUE:
+                std::cout << "null\n";
+                break;
+        }
+        // Walk up to the next pending child, closing what finished
+        bool descending = false;
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            std::string indentation(top.indent, ' ');
+            if (top.container->type() == JSONValue::Type::OBJECT) {
+                const auto& object = top.container->objectValue();
+                if (top.next < object.size()) {
+                    const auto& [key, val] = *(object.begin() + top.next);
+                    std::cout << indentation << "  \"" << key << "\": ";
+                    current = &val;
+                    currentIndent = top.indent + 2;
+                    top.next++;
+                    descending = true;
+                    break;
+                }
+                std::cout << indentation << "}\n";
+            } else {
+                const auto& array = top.container->arrayValue();
+                if (top.next < array.size()) {
+                    current = &array[top.next];
+                    currentIndent = top.indent + 2;
+                    top.next++;
+                    descending = true;
+                    break;
+                }
+                std::cout << indentation << "]\n";
+            }
+            stack.pop_back();
+        }
+        if (!descending) {
+            return;
+        }
+    }
+}
+
+inline size_t countKeys(const JSONValue& value) {
+    if (value.type() == JSONValue::Type::OBJECT) {
+        return value.objectValue().size();
+    }
+    throw std::runtime_error("countKeys: JSON value is not an object");
+}
+
+inline bool containsKey(const JSONValue& value, const std::string& key) {
+    if (value.type() == JSONValue::Type::OBJECT) {
+        return value.objectValue().find(key) != value.objectValue().end();
+    }
+    throw std::runtime_error("containsKey: JSON value is not an object");
+}
+
+inline void flattenJSON(const JSONValue& value, std::unordered_map<std::string, JSONValue>& flattened, const std::string& prefix = "") {
+    if (value.type() == JSONValue::Type::OBJECT) {
+        for (const auto& [key, val] : value.objectValue()) {
+            std::string newKey = prefix.empty() ? key : prefix + "." + key;
+            flattenJSON(val, flattened, newKey);
+        }
+    } else {
+        flattened[prefix] = value;
+    }
+}
+
+inline JSONValue unflattenJSON(const std::unordered_map<std::string, JSONValue>& flattened) {
+    JSONValue result(JSONValue::Type::OBJECT);
+    for (const auto& [flatKey, val] : flattened) {
+        std::stringstream ss(flatKey);
+        std::string token;
+        JSONValue* current = &result;
+
+        while (std::getline(ss, token, '.')) {
+            if (current->type() != JSONValue::Type::OBJECT) {
+                *current = JSONValue(JSONValue::Type::OBJECT);
+            }
+            if (!current->objectValue().count(token)) {
+                current->objectValue()[token] = JSONValue(JSONValue::Type::OBJECT);
+            }
+            current = &current->objectValue()[token];
+        }
+        *current = val;
+    }
+    return result;
+}
+
+inline std::vector<std::string> findKeysByPrefix(const JSONValue& value, const std::string& prefix) {
+    std::vector<std::string> result;
+    if (value.type() == JSONValue::Type::OBJECT) {
+        for (const auto& [key, _] : value.objectValue()) {
+            if (key.find(prefix) == 0) {
+                result.push_back(key);
+            }
+        }
+    } else {
+        throw std::runtime_error("findKeysByPrefix: JSON value is not an object");
+    }
+    return result;
+}
+
+inline void getLeafKeys(const JSONValue& value, std::vector<std::string>& leafKeys, const std::string& prefix = "") {
+    if (value.type() == JSONValue::Type::OBJECT) {
+        for (const auto& [key, val] : value.objectValue()) {
+            std::string fullKey = prefix.empty() ? key : prefix + "." + key;
+            getLeafKeys(val, leafKeys, fullKey);
+        }
+    } else if (value.type() != JSONValue::Type::NULLVALUE) {
+        leafKeys.push_back(prefix);
+    }
+}
+
+// ---- Document index ----
+// Query services hit findKeysByPrefix / getLeafKeys / queryJSON over and
+// over on the same loaded document, and each call re-walked the tree.
+// JSONIndex builds two tables in one traversal -- the sorted top-level
+// keys and the sorted dotted leaf paths with their node pointers -- so
+// repeated lookups become binary searches. The tables rebuild lazily
+// after a mutation, the same way JSONObject re-derives its hash index:
+// the mutation hooks below just mark the index stale.
+class JSONIndex {
+public:
+    explicit JSONIndex(JSONValue& document) : root(&document) {}
+
+    // Mark the tables stale; the next lookup rebuilds them
+    void invalidate() { stale = true; }
+
+    JSONValue& document() { invalidate(); return *root; }
+    const JSONValue& document() const { return *root; }
+
+    // Top-level keys starting with `prefix`, via one binary search for
+    // the start of the range instead of a scan over every key
+    std::vector<std::string> keysByPrefix(std::string_view prefix) const {
+        refresh();
+        std::vector<std::string> result;
+        auto it = std::lower_bound(keys.begin(), keys.end(), prefix);
+        while (it != keys.end() && it->starts_with(prefix)) {
+            result.emplace_back(*it);
+            ++it;
+        }
+        return result;
+    }
+
+    // Dotted paths of every non-null leaf, in sorted order
+    std::vector<std::string> leafPaths() const {
+        refresh();
+        std::vector<std::string> result;
+        result.reserve(leaves.size());
+        for (const auto& [path, _] : leaves) {
+            result.push_back(path);
+        }
+        return result;
+    }
+
+    // Resolve a dotted leaf path; nullptr when it is absent or names a
+    // container (containers are not in the leaf table)
+    const JSONValue* findLeaf(std::string_view path) const {
+        refresh();
+        auto it = std::lower_bound(leaves.begin(), leaves.end(), path,
+            [](const auto& entry, std::string_view target) { return entry.first < target; });
+        if (it == leaves.end() || it->first != path) {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+private:
+    void refresh() const {
+        if (!stale) {
+            return;
+        }
+        keys.clear();
+        leaves.clear();
+        if (root->type() == JSONValue::Type::OBJECT) {
+            for (const auto& [key, _] : root->objectValue()) {
+                keys.push_back(key);
+            }
+            std::sort(keys.begin(), keys.end());
+        }
+        collect(*root, "");
+        std::sort(leaves.begin(), leaves.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        stale = false;
+    }
+
+    // Same walk and skip-null rule as getLeafKeys, plus the node pointer
+    void collect(const JSONValue& node, const std::string& prefix) const {
+        if (node.type() == JSONValue::Type::OBJECT) {
+            for (const auto& [key, val] : node.objectValue()) {
+                collect(val, prefix.empty() ? key : prefix + "." + key);
+            }
+        } else if (node.type() != JSONValue::Type::NULLVALUE) {
+            leaves.emplace_back(prefix, &node);
+        }
+    }
+
+    JSONValue* root;
+    mutable std::vector<std::string> keys;
+    mutable std::vector<std::pair<std::string, const JSONValue*>> leaves;
+    mutable bool stale = true;
+
+    friend class JSONEditTransaction;
+};
+
+// A batch of edits against an indexed document. root() hands out the
+// document without touching the index, so a burst of updateJSON /
+// emplaceBack / spliceArray / adoptKey calls pays for one invalidation
+// at commit() (or destruction) instead of one per edit.
+class JSONEditTransaction {
+public:
+    explicit JSONEditTransaction(JSONIndex& target) : index(&target) {}
+    ~JSONEditTransaction() { commit(); }
+
+    JSONEditTransaction(const JSONEditTransaction&) = delete;
+    JSONEditTransaction& operator=(const JSONEditTransaction&) = delete;
+
+    JSONValue& root() { return *index->root; }
+
+    void commit() {
+        if (!committed) {
+            index->invalidate();
+            committed = true;
+        }
+    }
+
+private:
+    JSONIndex* index;
+    bool committed = false;
+};
+
+inline std::vector<std::string> findKeysByPrefix(const JSONIndex& index, const std::string& prefix) {
+    if (index.document().type() != JSONValue::Type::OBJECT) {
+        throw std::runtime_error("findKeysByPrefix: JSON value is not an object");
+    }
+    return index.keysByPrefix(prefix);
+}
+
+inline void getLeafKeys(const JSONIndex& index, std::vector<std::string>& leafKeys) {
+    std::vector<std::string> paths = index.leafPaths();
+    leafKeys.insert(leafKeys.end(), paths.begin(), paths.end());
+}
+
+inline JSONValue queryJSON(const JSONIndex& index, const std::string& path) {
+    if (const JSONValue* leaf = index.findLeaf(path)) {
+        return *leaf;
+    }
+    // Container-valued paths and array indices fall back to the walk
+    return queryJSON(index.document(), path);
+}
+
+// Mutation hooks: route edits through the index so its tables go stale
+// exactly when the document changes underneath them
+inline void updateJSON(JSONIndex& index, const std::string& key, const JSONValue& newValue) {
+    updateJSON(index.document(), key, newValue);
+}
+
+inline void deleteKey(JSONIndex& index, const std::string& key) {
+    deleteKey(index.document(), key);
+}
+
+inline void mergeJSON(JSONIndex& index, const JSONValue& source) {
+    mergeJSON(index.document(), source);
+}
+
+inline bool areEqual(const JSONValue& a, const JSONValue& b) {
+    if (a.type() != b.type()) return false;
+
+    // Two values backed by the same shared subtree are equal by identity
+    const void* identity = a.sharedIdentity();
+    if (identity && identity == b.sharedIdentity()) return true;
+
+    switch (a.type()) {
+        case JSONValue::Type::OBJECT:
+            if (a.objectValue().size() != b.objectValue().size()) return false;
+        for (const auto& [key, val] : a.objectValue()) {
+            if (!b.objectValue().count(key) || !areEqual(val, b.objectValue().at(key))) return false;
+        }
+        return true;
+        case JSONValue::Type::ARRAY:
+            if (a.arrayValue().size() != b.arrayValue().size()) return false;
+        for (size_t i = 0; i < a.arrayValue().size(); ++i) {
+            if (!areEqual(a.arrayValue()[i], b.arrayValue()[i])) return false;
+        }
+        return true;
+        case JSONValue::Type::STRING:
+            return a.stringView() == b.stringView();
+        case JSONValue::Type::NUMBER:
+            return a.numberValue() == b.numberValue();
+        case JSONValue::Type::BOOLEAN:
+            return a.boolValue() == b.boolValue();
+        case JSONValue::Type::NULLVALUE:
+            return true;
+    }
+    return false;
+}
+
+// ---- Parallel tree algorithms ----
+// The top level of a large document naturally partitions into
+// independent subtrees (distinct object keys, array slices), so these
+// fan that level out across the shared TaskPool and run the sequential
+// algorithm inside each task. Results are identical to the sequential
+// versions regardless of scheduling. One caveat: documents parsed in
+// lazy mode decode scalars on first access, which is not safe from two
+// threads at once — materialize them (or skip lazy mode) before
+// comparing or flattening in parallel.
+
+// Parallel merge. The slots for incoming keys are created sequentially
+// up front; the per-key subtree merges and copies, which dominate the
+// cost, then run across the pool.
+inline void mergeJSONParallel(JSONValue& target, const JSONValue& source,
+                              TaskPool& pool = TaskPool::shared()) {
+    if (target.type() != JSONValue::Type::OBJECT || source.type() != JSONValue::Type::OBJECT) {
+        mergeJSON(target, source);
+        return;
+    }
+    // Insert every missing slot first so the member vector stops moving
+    // before any pointers into it are taken
+    std::vector<bool> existed;
+    existed.reserve(source.objectValue().size());
+    for (const auto& [key, val] : source.objectValue()) {
+        bool present = target.objectValue().count(key) != 0;
+        existed.push_back(present);
+        if (!present) {
+            target.objectValue()[key];
+        }
+    }
+    struct Job {
+        JSONValue* into;
+        const JSONValue* from;
+        bool merge;
+    };
+    std::vector<Job> jobs;
+    jobs.reserve(source.objectValue().size());
+    size_t index = 0;
+    for (const auto& [key, val] : source.objectValue()) {
+        jobs.push_back({&target.objectValue().at(key), &val, existed[index++]});
+    }
+    pool.forEach(jobs.size(), [&jobs](size_t idx) {
+        if (jobs[idx].merge) {
+            mergeJSON(*jobs[idx].into, *jobs[idx].from);
+        } else {
+            *jobs[idx].into = *jobs[idx].from;
+        }
+    });
+}
+
+// Parallel deep equality; false as soon as any task finds a mismatch
+inline bool areEqualParallel(const JSONValue& a, const JSONValue& b,
+                             TaskPool& pool = TaskPool::shared()) {
+    if (a.type() != b.type()) {
+        return false;
+    }
+    const void* identity = a.sharedIdentity();
+    if (identity && identity == b.sharedIdentity()) {
+        return true;
+    }
+    if (a.type() == JSONValue::Type::ARRAY) {
+        if (a.arrayValue().size() != b.arrayValue().size()) {
+            return false;
+        }
+        std::atomic<bool> equal{true};
+        pool.forEach(a.arrayValue().size(), [&](size_t idx) {
+            if (equal.load(std::memory_order_relaxed) &&
+                !areEqual(a.arrayValue()[idx], b.arrayValue()[idx])) {
+                equal.store(false, std::memory_order_relaxed);
+            }
+        });
+        return equal.load();
+    }
+    if (a.type() == JSONValue::Type::OBJECT) {
+        const auto& object = a.objectValue();
+        if (object.size() != b.objectValue().size()) {
+            return false;
+        }
+        // Warm b's lazy hash index on this thread; the parallel lookups
+        // below must only read it
+        b.objectValue().find(std::string_view{});
+        std::atomic<bool> equal{true};
+        pool.forEach(object.size(), [&](size_t idx) {
+            if (!equal.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const auto& [key, val] = *(object.begin() + idx);
+            auto hit = b.objectValue().find(key);
+            if (hit == b.objectValue().end() || !areEqual(val, hit->second)) {
+                equal.store(false, std::memory_order_relaxed);
+            }
+        });
+        return equal.load();
+    }
+    return areEqual(a, b);
+}
+
+// Parallel flatten: each top-level member flattens into its own map,
+// and the disjoint partials are folded into the destination afterwards
+inline void flattenJSONParallel(const JSONValue& value,
+                                std::unordered_map<std::string, JSONValue>& flattened,
+                                TaskPool& pool = TaskPool::shared()) {
+    if (value.type() != JSONValue::Type::OBJECT) {
+        flattenJSON(value, flattened);
+        return;
+    }
+    const auto& object = value.objectValue();
+    std::vector<std::unordered_map<std::string, JSONValue>> partials(object.size());
+    pool.forEach(object.size(), [&](size_t idx) {
+        const auto& [key, val] = *(object.begin() + idx);
+        flattenJSON(val, partials[idx], key);
+    });
+    for (auto& partial : partials) {
+        for (auto& [key, val] : partial) {
+            flattened[key] = std::move(val);
+        }
+    }
+}
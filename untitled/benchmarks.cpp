@@ -0,0 +1,169 @@
+//
+// Benchmark harness for the JSON parser.
+//
+// The old benchmark() free function timed a single parse with one clock
+// pair; this target runs warmed, repeated iterations over corpora with
+// very different shapes and reports median/p99 latency plus throughput,
+// so regressions can be tracked release to release:
+//
+//   ./json_benchmarks
+//
+
+#include "JSONValue.h"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+
+namespace {
+
+constexpr int kWarmupIterations = 3;
+constexpr int kTimedIterations = 25;
+
+// Run one benchmark: warm up, time kTimedIterations runs, report median
+// and p99 in ns/op plus MB/s computed from the median
+void runBench(const std::string& name, size_t bytes, const std::function<void()>& fn) {
+    for (int i = 0; i < kWarmupIterations; ++i) {
+        fn();
+    }
+    std::vector<double> samples;
+    samples.reserve(kTimedIterations);
+    for (int i = 0; i < kTimedIterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+    double p99 = samples[(samples.size() * 99) / 100];
+    double mbPerSec = bytes > 0 ? (bytes / (median / 1e9)) / (1024.0 * 1024.0) : 0.0;
+
+    std::cout << std::left << std::setw(34) << name
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << median << " ns/op"
+              << std::setw(14) << p99 << " p99";
+    if (bytes > 0) {
+        std::cout << std::setprecision(1) << std::setw(10) << mbPerSec << " MB/s";
+    }
+    std::cout << "\n";
+}
+
+// ---- Representative corpora ----
+
+// Telemetry-style: many small flat objects sharing the same keys
+std::string makeSmallObjects(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) json += ',';
+        json += R"({"timestamp":)" + std::to_string(1700000000 + i) +
+                R"(,"host":"node-)" + std::to_string(i % 64) +
+                R"(","level":"info","value":)" + std::to_string(i * 0.5) + "}";
+    }
+    json += "]";
+    return json;
+}
+
+// Adversarially deep nesting
+std::string makeDeepNesting(size_t depth) {
+    std::string json;
+    for (size_t i = 0; i < depth; ++i) json += R"({"a":)";
+    json += "1";
+    for (size_t i = 0; i < depth; ++i) json += "}";
+    return json;
+}
+
+// One wide array of numbers
+std::string makeLargeArray(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) json += ',';
+        json += std::to_string(i * 1.25);
+    }
+    json += "]";
+    return json;
+}
+
+// Long strings, a few with escapes
+std::string makeStringHeavy(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) json += ',';
+        json += "\"payload payload payload payload payload payload " + std::to_string(i);
+        if (i % 20 == 0) json += "\\n\\ttail";
+        json += "\"";
+    }
+    json += "]";
+    return json;
+}
+
+// Mixed-width numeric data
+std::string makeNumberHeavy(size_t count) {
+    std::string json = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i) json += ',';
+        switch (i % 3) {
+            case 0: json += std::to_string(i); break;
+            case 1: json += std::to_string(i * 0.000123); break;
+            default: json += std::to_string(i) + "e-3"; break;
+        }
+    }
+    json += "]";
+    return json;
+}
+
+void benchCorpus(const std::string& name, const std::string& json) {
+    runBench(name + "/parse", json.size(), [&] {
+        JSONParser parser(json);
+        JSONValue value = parser.parse();
+        (void)value;
+    });
+    runBench(name + "/parse zero-copy", json.size(), [&] {
+        JSONParser parser{std::string_view(json)};
+        JSONValue value = parser.parse();
+        (void)value;
+    });
+
+    JSONValue document = JSONParser(json).parse();
+    std::string serialized;
+    runBench(name + "/serialize", serializeJSON(document).size(), [&] {
+        serialized.clear();
+        JSONWriter writer(serialized);
+        writer.write(document);
+    });
+}
+
+} // namespace
+
+int main() {
+    std::cout << "corpus/operation                          median           p99   throughput\n";
+
+    benchCorpus("small-objects", makeSmallObjects(20000));
+    benchCorpus("deep-nesting", makeDeepNesting(900));
+    benchCorpus("large-array", makeLargeArray(200000));
+    benchCorpus("string-heavy", makeStringHeavy(20000));
+    benchCorpus("number-heavy", makeNumberHeavy(200000));
+
+    // Tree-level operations on the small-object corpus
+    JSONValue records = JSONParser(makeSmallObjects(20000)).parse();
+    JSONPath path = JSONPath::compile("12345.host");
+    runBench("queryJSON/compiled-path", 0, [&] {
+        const JSONValue* hit = path.evaluate(records);
+        if (!hit) throw std::runtime_error("benchmark path missed");
+    });
+
+    JSONValue left = JSONParser(std::string(R"({"a":{"x":1},"b":[1,2,3],"c":"s"})")).parse();
+    JSONValue right = JSONParser(std::string(R"({"a":{"y":2},"d":false})")).parse();
+    runBench("mergeJSON/small-trees", 0, [&] {
+        JSONValue target = left;
+        mergeJSON(target, right);
+    });
+
+    JSONValue nested = JSONParser(makeDeepNesting(400)).parse();
+    runBench("flattenJSON/deep-tree", 0, [&] {
+        std::unordered_map<std::string, JSONValue> flat;
+        flattenJSON(nested, flat);
+    });
+
+    return 0;
+}